@@ -5,22 +5,31 @@
 
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
-#include "Components/WidgetComponent.h"
 #include "ShooterCharacter.h"
+#include "ItemWorldSubsystem.h"
+#include "Slime.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ammo Stacks Merged"), STAT_AmmoStacksMerged, STATGROUP_Slime);
 
-AAmmo::AAmmo()
+
+// Ammo is a static mesh already, so skip the Item's skeletal mesh and its static stand-in.
+AAmmo::AAmmo(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer
+		.DoNotCreateDefaultSubobject(TEXT("ItemMesh"))
+		.DoNotCreateDefaultSubobject(TEXT("PickupMesh"))),
+	StackRadius(150.f),
+	MaxStackCount(999)
 {
 	AmmoMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AmmoMesh"));
 	SetRootComponent(AmmoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
-	GetPickupWidget()->SetupAttachment(GetRootComponent());
 	GetAreaSphere()->SetupAttachment(GetRootComponent());
 
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
 	AmmoCollisionSphere->SetupAttachment(GetRootComponent());
 	AmmoCollisionSphere->SetSphereRadius(50.f);
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);  // Enabled in ActivateItem().
 }
 
 void AAmmo::Tick(float DeltaTime)
@@ -29,11 +38,14 @@ void AAmmo::Tick(float DeltaTime)
 
 }
 
-void AAmmo::BeginPlay()
+void AAmmo::ActivateItem()
 {
-	Super::BeginPlay();
+	if (IsActivated()) return;
 
+	// Bind before activating, since activation may merge this stack into another and destroy it.
 	AmmoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AAmmo::AmmoSphereOverlap);
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Super::ActivateItem();
 }
 
 
@@ -59,11 +71,11 @@ void AAmmo::SetItemProperties(EItemState State)
 
 		break;
 	case EItemState::EIS_Falling:
-		AmmoMesh->SetSimulatePhysics(true);
-		AmmoMesh->SetEnableGravity(true);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		// Moved kinematically by UpdateFalling(), so no physics body is needed.
+		AmmoMesh->SetSimulatePhysics(false);
+		AmmoMesh->SetVisibility(true);
 		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECR_Block);
+		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 		break;
 	case EItemState::EIS_EquipInterping:
@@ -89,13 +101,68 @@ void AAmmo::ItemInterping(float DeltaTime)
 	SetActorScale3D(InterpScale);
 }
 
+void AAmmo::OnEnterGround()
+{
+	Super::OnEnterGround();
+
+	// Picking the stack up turned its collision off; a remainder dropped back can be picked up again.
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+	UItemWorldSubsystem* ItemSubsystem{ GetWorld()->GetSubsystem<UItemWorldSubsystem>() };
+	if (ItemSubsystem == nullptr) return;
+
+	TArray<AItem*> NearbyItems;
+	ItemSubsystem->QueryGroundItems(GetActorLocation(), StackRadius, NearbyItems);
+	for (AItem* NearbyItem : NearbyItems)
+	{
+		AAmmo* Stack = Cast<AAmmo>(NearbyItem);
+		if (Stack == nullptr || Stack == this || Stack->GetAmmoType() != AmmoType) continue;
+		if (Stack->GetItemCount() + GetItemCount() > Stack->MaxStackCount) continue;
+
+		// The existing stack absorbs this one, so stacks don't wander as ammo lands next to them.
+		Stack->SetItemCount(Stack->GetItemCount() + GetItemCount());
+		INC_DWORD_STAT(STAT_AmmoStacksMerged);
+		Destroy();
+		return;
+	}
+}
+
+void AAmmo::SplitStack(int32 Amount)
+{
+	Amount = FMath::Min(Amount, GetItemCount());
+	if (Amount <= 0) return;
+
+	FItemSpawnParams Params;
+	Params.Rarity = GetItemRarity();
+	Params.ItemCount = Amount;
+	Params.SubType = static_cast<uint8>(AmmoType);
+	SetItemCount(GetItemCount() - Amount);
+	if (AItem::SpawnItem(GetWorld(), GetClass(), GetActorTransform(), Params) == nullptr)
+	{
+		SetItemCount(GetItemCount() + Amount);
+	}
+}
+
+void AAmmo::BeginEquip(AShooterCharacter* InstigatingCharacter)
+{
+	const int32 AmmoSpace{ InstigatingCharacter->GetAmmoSpace(AmmoType) };
+	if (AmmoSpace <= 0) return;
+
+	// Leave the ground first, so the remainder doesn't merge straight back into this stack.
+	Super::BeginEquip(InstigatingCharacter);
+	if (AmmoSpace < GetItemCount())
+	{
+		SplitStack(GetItemCount() - AmmoSpace);
+	}
+}
+
 void AAmmo::AmmoSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
 	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	if (OtherActor)
 	{
 		const auto PlayerCharacter = Cast<AShooterCharacter>(OtherActor);
-		if (PlayerCharacter)
+		if (PlayerCharacter && PlayerCharacter->GetAmmoSpace(AmmoType) > 0)
 		{
 			BeginEquip(PlayerCharacter);
 			AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
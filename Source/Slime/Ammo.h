@@ -15,13 +15,14 @@ class SLIME_API AAmmo : public AItem
 {
 	GENERATED_BODY()
 public:
-	AAmmo();
+	AAmmo(const FObjectInitializer& ObjectInitializer);
 
 	virtual void Tick(float DeltaTime) override;
 
 protected:
 	
-	virtual void BeginPlay() override;
+	/** Also binds the ammo collision sphere, so ammo that is not yet activated can't be picked up. */
+	virtual void ActivateItem() override;
 
 	/** Override of SetItemProperties to set properties for an Ammo Static Mesh Component, not a Skeletal Mesh.  */
 	virtual void SetItemProperties(EItemState State) override;
@@ -29,6 +30,12 @@ protected:
 	/** Used to interpolate item scale on pickup, and calls super to interpolate location and rotation. */
 	virtual void ItemInterping(float DeltaTime) override;
 
+	/** Merges into a nearby stack of the same ammo type, if there is one with room. */
+	virtual void OnEnterGround() override;
+
+	/** Leaves Amount behind on the ground as a new stack, and keeps the rest in this one. */
+	void SplitStack(int32 Amount);
+
 	
 	void SphereCollisionOverlap();
 
@@ -54,11 +61,22 @@ private:
 	/** Overlap sphere for picking up ammo by character collision. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	class USphereComponent* AmmoCollisionSphere;
+
+	/** Ground ammo of the same type within this distance is merged into one stack. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float StackRadius;
+
+	/** Largest count a merged stack may hold. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ammo, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxStackCount;
 	
 public:
 
 	FORCEINLINE UStaticMeshComponent* GetAmmoMesh() const { return AmmoMesh; }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType;  }
+	FORCEINLINE void SetAmmoType(const EAmmoType Type) { AmmoType = Type; }
+	/** Picks up only as much as the character can carry, splitting the stack if needed. */
+	virtual void BeginEquip(AShooterCharacter* InstigatingCharacter) override;
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
 };
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AnimNotify_Footstep.h"
+
+#include "ShooterCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+
+UAnimNotify_Footstep::UAnimNotify_Footstep() :
+	VolumeMultiplier(1.f)
+{
+}
+
+void UAnimNotify_Footstep::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	Super::Notify(MeshComp, Animation);
+
+	if (AShooterCharacter* Character = MeshComp ? Cast<AShooterCharacter>(MeshComp->GetOwner()) : nullptr)
+	{
+		Character->PlayFootstep(MeshComp->GetSocketLocation(FootSocketName), VolumeMultiplier);
+	}
+}
+
+FString UAnimNotify_Footstep::GetNotifyName_Implementation() const
+{
+	return FootSocketName.IsNone() ? TEXT("Footstep") : FString::Printf(TEXT("Footstep %s"), *FootSocketName.ToString());
+}
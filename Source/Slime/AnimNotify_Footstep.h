@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "AnimNotify_Footstep.generated.h"
+
+/**
+ * Plays the owning shooter character's footstep sound for the surface it is standing on, natively, instead of
+ * the animation Blueprint querying the surface and picking a sound itself.
+ */
+UCLASS(meta = (DisplayName = "Footstep"))
+class SLIME_API UAnimNotify_Footstep : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	UAnimNotify_Footstep();
+
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+	virtual FString GetNotifyName_Implementation() const override;
+
+private:
+	/** Socket the sound plays at, e.g. the foot that lands. None plays it at the mesh. */
+	UPROPERTY(EditAnywhere, Category = Footstep)
+	FName FootSocketName;
+
+	UPROPERTY(EditAnywhere, Category = Footstep, meta = (ClampMin = "0.0"))
+	float VolumeMultiplier;
+};
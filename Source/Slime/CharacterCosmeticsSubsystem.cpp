@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CharacterCosmeticsSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Slime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cosmetics Gather"), STAT_CosmeticsGather, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Cosmetics Kernels"), STAT_CosmeticsKernels, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Cosmetics Scatter"), STAT_CosmeticsScatter, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetics Batched Characters"), STAT_CosmeticsBatchedCharacters, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarCosmeticsBatched(
+	TEXT("slime.Cosmetics.Batched"),
+	1,
+	TEXT("1: characters' crosshair spread and FOV are interpolated together by the cosmetics subsystem. 0: each character interpolates its own in Tick()."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarCosmeticsMinParallelCharacters(
+	TEXT("slime.Cosmetics.MinParallelCharacters"),
+	64,
+	TEXT("Batches with fewer awake characters than this run the kernels on the game thread; the task overhead would outweigh them."),
+	ECVF_Default);
+
+namespace
+{
+	/** Lanes per vector register. */
+	constexpr int32 LaneWidth{ 4 };
+
+	/** Registers processed by one ParallelFor task. */
+	constexpr int32 RegistersPerTask{ 8 };
+
+	/** FMath::FInterpTo on four lanes. */
+	FORCEINLINE VectorRegister VectorInterpTo(VectorRegister Current, VectorRegister Target, VectorRegister DeltaTime, VectorRegister Speed)
+	{
+		const VectorRegister Zero{ VectorZero() };
+		const VectorRegister Alpha{ VectorMin(VectorMax(VectorMultiply(DeltaTime, Speed), Zero), VectorOne()) };
+		const VectorRegister Dist{ VectorSubtract(Target, Current) };
+		const VectorRegister Moved{ VectorMultiplyAdd(Dist, Alpha, Current) };
+
+		// Like FInterpTo, land on the target when it is closer than SMALL_NUMBER squared, or the speed isn't positive.
+		const VectorRegister Snap{ VectorBitwiseOr(
+			VectorCompareLT(VectorMultiply(Dist, Dist), VectorSetFloat1(SMALL_NUMBER)),
+			VectorCompareLE(Speed, Zero)) };
+		return VectorSelect(Snap, Target, Moved);
+	}
+
+	/** Interpolates the lanes of one register: velocity factor, the three spread factors, and FOV. */
+	FORCEINLINE void RunKernels(FCharacterCosmeticsBatch& Batch, int32 Lane, VectorRegister DeltaTime)
+	{
+		// Lateral speed 0 to ShooterCrosshair::MaxVelocitySpeed maps to a velocity factor of 0 to 1.
+		const VectorRegister Speed{ VectorLoadAligned(&Batch.LateralSpeed[Lane]) };
+		const VectorRegister InvMaxSpeed{ VectorSetFloat1(1.f / ShooterCrosshair::MaxVelocitySpeed) };
+		const VectorRegister VelocityFactor{ VectorMin(VectorMax(VectorMultiply(Speed, InvMaxSpeed), VectorZero()), VectorOne()) };
+		VectorStoreAligned(VelocityFactor, &Batch.VelocityFactor[Lane]);
+
+		VectorStoreAligned(VectorInterpTo(
+			VectorLoadAligned(&Batch.InAirFactor[Lane]),
+			VectorLoadAligned(&Batch.InAirTarget[Lane]),
+			DeltaTime,
+			VectorLoadAligned(&Batch.InAirSpeed[Lane])), &Batch.InAirFactor[Lane]);
+
+		VectorStoreAligned(VectorInterpTo(
+			VectorLoadAligned(&Batch.AimFactor[Lane]),
+			VectorLoadAligned(&Batch.AimTarget[Lane]),
+			DeltaTime,
+			VectorSetFloat1(ShooterCrosshair::AimSpeed)), &Batch.AimFactor[Lane]);
+
+		VectorStoreAligned(VectorInterpTo(
+			VectorLoadAligned(&Batch.ShootingFactor[Lane]),
+			VectorLoadAligned(&Batch.ShootingTarget[Lane]),
+			DeltaTime,
+			VectorLoadAligned(&Batch.ShootingSpeed[Lane])), &Batch.ShootingFactor[Lane]);
+
+		VectorStoreAligned(VectorInterpTo(
+			VectorLoadAligned(&Batch.FOV[Lane]),
+			VectorLoadAligned(&Batch.FOVTarget[Lane]),
+			DeltaTime,
+			VectorLoadAligned(&Batch.FOVSpeed[Lane])), &Batch.FOV[Lane]);
+	}
+}
+
+void FCharacterCosmeticsBatch::Reset()
+{
+	Characters.Reset();
+	Interpolators.Reset();
+	Falling.Reset();
+	ForEachLanes([](FLanes& Lanes) { Lanes.Reset(); });
+}
+
+int32 FCharacterCosmeticsBatch::Add(AShooterCharacter* Character, EShooterInterpolator CharacterInterpolators)
+{
+	const int32 Index{ Characters.Add(Character) };
+	Interpolators.Add(CharacterInterpolators);
+	Falling.Add(false);
+	ForEachLanes([](FLanes& Lanes) { Lanes.Add(0.f); });
+	return Index;
+}
+
+void FCharacterCosmeticsBatch::Pad()
+{
+	const int32 NumPadded{ Align(Num(), LaneWidth) };
+	ForEachLanes([NumPadded](FLanes& Lanes) { Lanes.SetNumZeroed(NumPadded); });
+}
+
+bool UCharacterCosmeticsSubsystem::IsBatchingEnabled()
+{
+	return CVarCosmeticsBatched.GetValueOnGameThread() != 0;
+}
+
+void UCharacterCosmeticsSubsystem::RegisterCharacter(AShooterCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UCharacterCosmeticsSubsystem::UnregisterCharacter(AShooterCharacter* Character)
+{
+	Characters.RemoveSwap(Character);
+}
+
+void UCharacterCosmeticsSubsystem::RunBatch(float DeltaTime)
+{
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CosmeticsGather);
+		Batch.Reset();
+		for (AShooterCharacter* Character : Characters)
+		{
+			const EShooterInterpolator Awake{ Character->GetActiveInterpolators() & EShooterInterpolator::Cosmetics };
+			if (Awake != EShooterInterpolator::None)
+			{
+				Character->GatherCosmetics(Batch, Batch.Add(Character, Awake));
+			}
+		}
+		Batch.Pad();
+	}
+	if (Batch.Num() == 0) return;
+	INC_DWORD_STAT_BY(STAT_CosmeticsBatchedCharacters, Batch.Num());
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CosmeticsKernels);
+		const VectorRegister DeltaTimeRegister{ VectorSetFloat1(DeltaTime) };
+		const int32 NumRegisters{ Batch.NumLanes() / LaneWidth };
+		const int32 NumTasks{ FMath::DivideAndRoundUp(NumRegisters, RegistersPerTask) };
+		const bool bSingleThread{ Batch.Num() < CVarCosmeticsMinParallelCharacters.GetValueOnGameThread() };
+		ParallelFor(NumTasks, [this, &DeltaTimeRegister, NumRegisters](int32 Task)
+		{
+			const int32 EndRegister{ FMath::Min((Task + 1) * RegistersPerTask, NumRegisters) };
+			for (int32 Register = Task * RegistersPerTask; Register < EndRegister; ++Register)
+			{
+				RunKernels(Batch, Register * LaneWidth, DeltaTimeRegister);
+			}
+		}, bSingleThread);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CosmeticsScatter);
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			Batch.Characters[Index]->ScatterCosmetics(Batch, Index);
+		}
+	}
+}
+
+void UCharacterCosmeticsSubsystem::Tick(float DeltaTime)
+{
+	RunBatch(DeltaTime);
+}
+
+bool UCharacterCosmeticsSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Characters.Num() > 0 && IsBatchingEnabled();
+}
+
+TStatId UCharacterCosmeticsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterCosmeticsSubsystem, STATGROUP_Tickables);
+}
+
+void UCharacterCosmeticsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bBatchingEnabled = IsBatchingEnabled();
+	ConsoleVariableSinkHandle = IConsoleManager::Get().RegisterConsoleVariableSink_Handle(
+		FConsoleCommandDelegate::CreateUObject(this, &UCharacterCosmeticsSubsystem::OnConsoleVariablesChanged));
+}
+
+void UCharacterCosmeticsSubsystem::OnConsoleVariablesChanged()
+{
+	const bool bWasBatchingEnabled{ bBatchingEnabled };
+	bBatchingEnabled = IsBatchingEnabled();
+	if (bBatchingEnabled || !bWasBatchingEnabled) return;
+
+	// Characters whose only awake interpolators were batched turned their actor tick off, and nothing else wakes them.
+	for (AShooterCharacter* Character : Characters)
+	{
+		Character->OnCosmeticsBatchingChanged();
+	}
+}
+
+void UCharacterCosmeticsSubsystem::Deinitialize()
+{
+	IConsoleManager::Get().UnregisterConsoleVariableSink_Handle(ConsoleVariableSinkHandle);
+	Characters.Empty();
+	Batch.Reset();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterCharacter.h"
+#include "CharacterCosmeticsSubsystem.generated.h"
+
+/**
+ * Inputs and results of the crosshair spread and camera FOV interpolators of every awake character, one array per
+ * value, so the kernels read four characters per vector register. Arrays are padded to a multiple of four lanes;
+ * padding lanes are zero and their results ignored.
+ */
+struct FCharacterCosmeticsBatch
+{
+	typedef TArray<float, TAlignedHeapAllocator<16>> FLanes;
+
+	TArray<AShooterCharacter*> Characters;
+	TArray<EShooterInterpolator> Interpolators;
+	TArray<bool> Falling;
+
+	FLanes LateralSpeed;
+	FLanes VelocityFactor;
+	FLanes InAirFactor;
+	FLanes InAirTarget;
+	FLanes InAirSpeed;
+	FLanes AimFactor;
+	FLanes AimTarget;
+	FLanes ShootingFactor;
+	FLanes ShootingTarget;
+	FLanes ShootingSpeed;
+	FLanes FOV;
+	FLanes FOVTarget;
+	FLanes FOVSpeed;
+
+	FORCEINLINE int32 Num() const { return Characters.Num(); }
+	FORCEINLINE int32 NumLanes() const { return LateralSpeed.Num(); }
+
+	void Reset();
+
+	/** Adds a character, and returns its index for AShooterCharacter::GatherCosmetics(). */
+	int32 Add(AShooterCharacter* Character, EShooterInterpolator CharacterInterpolators);
+
+	/** Zeroes the lanes past the last character, up to the next multiple of four. */
+	void Pad();
+
+private:
+	template <typename FunctionType>
+	void ForEachLanes(FunctionType&& Function)
+	{
+		for (FLanes* Lanes : { &LateralSpeed, &VelocityFactor, &InAirFactor, &InAirTarget, &InAirSpeed, &AimFactor, &AimTarget,
+			&ShootingFactor, &ShootingTarget, &ShootingSpeed, &FOV, &FOVTarget, &FOVSpeed })
+		{
+			Function(*Lanes);
+		}
+	}
+};
+
+/**
+ * Advances the crosshair spread and camera FOV of every shooter character in one pass: inputs are gathered into
+ * FCharacterCosmeticsBatch on the game thread, interpolated four characters at a time with ParallelFor, and scattered
+ * back. Characters then only tick for what isn't batched. Toggled by slime.Cosmetics.Batched.
+ *
+ * FTickableGameObjects tick in UWorld::Tick after the last tick group and before the player camera managers update,
+ * so the FOV scattered here is on the camera component when the view is taken, the same frame, as when characters
+ * interpolate in their own Tick(). Moving the batch later, e.g. to an end of frame delegate, would lag it a frame.
+ */
+UCLASS()
+class SLIME_API UCharacterCosmeticsSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** True if characters leave their crosshair spread and FOV to this subsystem. */
+	static bool IsBatchingEnabled();
+
+	void RegisterCharacter(AShooterCharacter* Character);
+	void UnregisterCharacter(AShooterCharacter* Character);
+
+	/** Gathers, interpolates and scatters the awake characters. Called by Tick(), and by slime.Character.BenchmarkCrowd. */
+	void RunBatch(float DeltaTime);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+protected:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	/** Console variable sink: hands the characters back to their own Tick() when batching is turned off. */
+	void OnConsoleVariablesChanged();
+
+	TArray<AShooterCharacter*> Characters;
+
+	/** slime.Cosmetics.Batched as of the last OnConsoleVariablesChanged(). */
+	bool bBatchingEnabled;
+
+	FConsoleVariableSinkHandle ConsoleVariableSinkHandle;
+
+	/** Kept between frames so the arrays aren't reallocated. */
+	FCharacterCosmeticsBatch Batch;
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CrosshairWidget.h"
+
+#include "SCrosshair.h"
+#include "ShooterCharacter.h"
+
+#define LOCTEXT_NAMESPACE "Slime"
+
+UCrosshairWidget::UCrosshairWidget() :
+	BaseOffset(0.f),
+	SpreadScale(16.f),
+	RepaintThreshold(0.5f)
+{
+	Visibility = ESlateVisibility::HitTestInvisible;
+}
+
+TSharedRef<SWidget> UCrosshairWidget::RebuildWidget()
+{
+	MyCrosshair = SNew(SCrosshair);
+	return MyCrosshair.ToSharedRef();
+}
+
+void UCrosshairWidget::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if (!MyCrosshair.IsValid()) return;
+
+	MyCrosshair->SetImages(&TopImage, &BottomImage, &LeftImage, &RightImage);
+	MyCrosshair->SetLayout(BaseOffset, SpreadScale, RepaintThreshold);
+	MyCrosshair->SetSpread(TAttribute<float>::Create(TAttribute<float>::FGetter::CreateUObject(this, &UCrosshairWidget::GetSpread)));
+}
+
+void UCrosshairWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	MyCrosshair.Reset();
+}
+
+float UCrosshairWidget::GetSpread() const
+{
+	const APlayerController* PlayerController{ GetOwningPlayer() };
+	const AShooterCharacter* Character{ PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr };
+	return Character ? Character->GetCrosshairSpreadMultiplier() : 0.f;
+}
+
+#if WITH_EDITOR
+const FText UCrosshairWidget::GetPaletteCategory()
+{
+	return LOCTEXT("Slime", "Slime");
+}
+#endif
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "Styling/SlateBrush.h"
+#include "CrosshairWidget.generated.h"
+
+class SCrosshair;
+
+/**
+ * UMG wrapper for SCrosshair. The spread comes straight from the owning player's character every frame, so the HUD
+ * needs no property binding for it; the crosshair repaints only when the spread has visibly changed.
+ */
+UCLASS()
+class SLIME_API UCrosshairWidget : public UWidget
+{
+	GENERATED_BODY()
+
+public:
+	UCrosshairWidget();
+
+	virtual void SynchronizeProperties() override;
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+	/** Spread multiplier of the owning player's character, or zero when there is none. */
+	float GetSpread() const;
+
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	FSlateBrush TopImage;
+
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	FSlateBrush BottomImage;
+
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	FSlateBrush LeftImage;
+
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	FSlateBrush RightImage;
+
+	/** Distance of each image from the center at zero spread, in pixels. */
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	float BaseOffset;
+
+	/** Pixels each image moves out per unit of spread multiplier. */
+	UPROPERTY(EditAnywhere, Category = Crosshair)
+	float SpreadScale;
+
+	/** Smallest movement, in pixels, worth a repaint. */
+	UPROPERTY(EditAnywhere, Category = Crosshair, meta = (ClampMin = "0.0"))
+	float RepaintThreshold;
+
+	TSharedPtr<SCrosshair> MyCrosshair;
+};
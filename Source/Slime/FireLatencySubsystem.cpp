@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireLatencySubsystem.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Slime.h"
+
+static TAutoConsoleVariable<int32> CVarFireLatencyEnabled(
+	TEXT("slime.FireLatency.Enabled"),
+	1,
+	TEXT("1: the latency of each stage of the fire path is recorded. 0: nothing is recorded."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld FireLatencyDumpCommand(
+	TEXT("slime.FireLatency.Dump"),
+	TEXT("Logs count, mean, min, max and percentiles of every fire path stage."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFireLatencySubsystem* Latency = World ? World->GetSubsystem<UFireLatencySubsystem>() : nullptr)
+		{
+			Latency->Dump();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld FireLatencyResetCommand(
+	TEXT("slime.FireLatency.Reset"),
+	TEXT("Clears the fire path latency histograms."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UFireLatencySubsystem* Latency = World ? World->GetSubsystem<UFireLatencySubsystem>() : nullptr)
+		{
+			Latency->Reset();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs FireLatencyWriteCSVCommand(
+	TEXT("slime.FireLatency.WriteCSV"),
+	TEXT("Writes the fire path latency histograms to a CSV file, Saved/Profiling/FireLatency-<date>.csv by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UFireLatencySubsystem* Latency{ World ? World->GetSubsystem<UFireLatencySubsystem>() : nullptr };
+		if (Latency == nullptr) return;
+
+		const FString Filename{ Args.Num() > 0
+			? Args[0]
+			: FPaths::ProfilingDir() / FString::Printf(TEXT("FireLatency-%s.csv"), *FDateTime::Now().ToString()) };
+		if (Latency->WriteCSV(Filename))
+		{
+			UE_LOG(LogSlime, Display, TEXT("Wrote fire latency histograms to %s"), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogSlime, Error, TEXT("Failed to write fire latency histograms to %s"), *Filename);
+		}
+	}));
+
+const double FFireLatencyHistogram::BucketEdges[]{ 0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 12.0, 16.7, 25.0, 33.3, 50.0, 100.0, 250.0 };
+
+void FFireLatencyHistogram::Add(double Ms)
+{
+	int32 Bucket{ 0 };
+	while (Bucket < NumEdges && Ms > BucketEdges[Bucket])
+	{
+		++Bucket;
+	}
+	++Buckets[Bucket];
+
+	MinMs = Count > 0 ? FMath::Min(MinMs, Ms) : Ms;
+	MaxMs = Count > 0 ? FMath::Max(MaxMs, Ms) : Ms;
+	TotalMs += Ms;
+	++Count;
+}
+
+void FFireLatencyHistogram::Reset()
+{
+	*this = FFireLatencyHistogram{};
+}
+
+double FFireLatencyHistogram::GetPercentileMs(double Percentile) const
+{
+	if (Count == 0) return 0.0;
+
+	const uint32 Rank{ static_cast<uint32>(FMath::CeilToDouble(Count * FMath::Clamp(Percentile, 0.0, 100.0) / 100.0)) };
+	uint32 Seen{ 0 };
+	for (int32 Bucket = 0; Bucket < NumEdges; ++Bucket)
+	{
+		Seen += Buckets[Bucket];
+		if (Seen >= FMath::Max(Rank, 1u))
+		{
+			return FMath::Min(BucketEdges[Bucket], MaxMs);
+		}
+	}
+	return MaxMs;
+}
+
+UFireLatencySubsystem* UFireLatencySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (CVarFireLatencyEnabled.GetValueOnGameThread() == 0) return nullptr;
+
+	const UWorld* World{ WorldContextObject ? WorldContextObject->GetWorld() : nullptr };
+	return World ? World->GetSubsystem<UFireLatencySubsystem>() : nullptr;
+}
+
+void UFireLatencySubsystem::Record(EFireLatencyStage Stage, double StartSeconds)
+{
+	if (StartSeconds <= 0.0) return;
+
+	// Frame-granular timers never run early in game time, but can by a hair in wall time.
+	const double Ms{ FMath::Max(0.0, (Now() - StartSeconds) * 1000.0) };
+	Histograms[static_cast<int32>(Stage)].Add(Ms);
+}
+
+const TCHAR* UFireLatencySubsystem::GetStageName(EFireLatencyStage Stage)
+{
+	switch (Stage)
+	{
+	case EFireLatencyStage::InputToShot: return TEXT("InputToShot");
+	case EFireLatencyStage::ShotResolve: return TEXT("ShotResolve");
+	case EFireLatencyStage::ShotToFX: return TEXT("ShotToFX");
+	case EFireLatencyStage::ShotToHUD: return TEXT("ShotToHUD");
+	case EFireLatencyStage::AutoFireTimerLateness: return TEXT("AutoFireTimerLateness");
+	default: return TEXT("?");
+	}
+}
+
+void UFireLatencySubsystem::Dump() const
+{
+	UE_LOG(LogSlime, Display, TEXT("Fire latency (ms):"));
+	for (int32 Index = 0; Index < static_cast<int32>(EFireLatencyStage::MAX); ++Index)
+	{
+		const FFireLatencyHistogram& Histogram{ Histograms[Index] };
+		UE_LOG(LogSlime, Display, TEXT("  %-22s count %6u  mean %8.3f  min %8.3f  max %8.3f  p50 <= %7.3f  p95 <= %7.3f  p99 <= %7.3f"),
+			GetStageName(static_cast<EFireLatencyStage>(Index)),
+			Histogram.Count,
+			Histogram.GetMeanMs(),
+			Histogram.MinMs,
+			Histogram.MaxMs,
+			Histogram.GetPercentileMs(50.0),
+			Histogram.GetPercentileMs(95.0),
+			Histogram.GetPercentileMs(99.0));
+	}
+}
+
+void UFireLatencySubsystem::Reset()
+{
+	for (FFireLatencyHistogram& Histogram : Histograms)
+	{
+		Histogram.Reset();
+	}
+}
+
+bool UFireLatencySubsystem::WriteCSV(const FString& Filename) const
+{
+	FString Csv{ TEXT("Stage,Count,MeanMs,MinMs,MaxMs,P50Ms,P95Ms,P99Ms") };
+	for (int32 Bucket = 0; Bucket < FFireLatencyHistogram::NumEdges; ++Bucket)
+	{
+		Csv += FString::Printf(TEXT(",<=%g"), FFireLatencyHistogram::BucketEdges[Bucket]);
+	}
+	Csv += FString::Printf(TEXT(",>%g\n"), FFireLatencyHistogram::BucketEdges[FFireLatencyHistogram::NumEdges - 1]);
+
+	for (int32 Index = 0; Index < static_cast<int32>(EFireLatencyStage::MAX); ++Index)
+	{
+		const FFireLatencyHistogram& Histogram{ Histograms[Index] };
+		Csv += FString::Printf(TEXT("%s,%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f"),
+			GetStageName(static_cast<EFireLatencyStage>(Index)),
+			Histogram.Count,
+			Histogram.GetMeanMs(),
+			Histogram.MinMs,
+			Histogram.MaxMs,
+			Histogram.GetPercentileMs(50.0),
+			Histogram.GetPercentileMs(95.0),
+			Histogram.GetPercentileMs(99.0));
+		for (const uint32 BucketCount : Histogram.Buckets)
+		{
+			Csv += FString::Printf(TEXT(",%u"), BucketCount);
+		}
+		Csv += TEXT("\n");
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
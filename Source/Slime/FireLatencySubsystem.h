@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FireLatencySubsystem.generated.h"
+
+/** Stages of the fire path whose latency is recorded. */
+enum class EFireLatencyStage : uint8
+{
+	/** FireButtonPressed() to the shot being accepted by FireWeapon(), including any wait on the fire timer or a reload. */
+	InputToShot,
+	/** The crosshair trace and beam end resolution of a shot. */
+	ShotResolve,
+	/** Shot accepted to its muzzle flash, impact and beam spawned. */
+	ShotToFX,
+	/** Shot accepted to the HUD model publishing the new magazine ammo. */
+	ShotToHUD,
+	/** How late AutoFireReset() ran past AutomaticFireRate. */
+	AutoFireTimerLateness,
+
+	MAX
+};
+
+/** Timestamps of a character's shot in flight, in FPlatformTime::Seconds(); 0 when the stage isn't pending. */
+struct FFireLatencyMarks
+{
+	double ButtonPressed{ 0.0 };
+	double ShotStarted{ 0.0 };
+	double HUDPending{ 0.0 };
+	double AutoFireDue{ 0.0 };
+};
+
+/**
+ * Latencies of one stage, counted into fixed buckets so recording is a few adds and never allocates.
+ * Percentiles are reported as the upper edge of the bucket they fall in.
+ */
+struct FFireLatencyHistogram
+{
+	/** Upper bucket edges in milliseconds; the last bucket holds everything above the last edge. */
+	static constexpr int32 NumEdges{ 14 };
+	static const double BucketEdges[NumEdges];
+	static constexpr int32 NumBuckets{ NumEdges + 1 };
+
+	uint32 Buckets[NumBuckets]{};
+	uint32 Count{ 0 };
+	double TotalMs{ 0.0 };
+	double MinMs{ 0.0 };
+	double MaxMs{ 0.0 };
+
+	void Add(double Ms);
+	void Reset();
+
+	FORCEINLINE double GetMeanMs() const { return Count > 0 ? TotalMs / Count : 0.0; }
+
+	/** Upper edge of the bucket holding the given percentile (0 to 100); MaxMs if it is in the last bucket. */
+	double GetPercentileMs(double Percentile) const;
+};
+
+/**
+ * Collects per-stage latency histograms of the fire path of every shooter character in the world. The character
+ * timestamps each stage as it is reached, see FFireLatencyMarks. Toggled by slime.FireLatency.Enabled; reported with
+ * slime.FireLatency.Dump, written out with slime.FireLatency.WriteCSV, and cleared with slime.FireLatency.Reset.
+ */
+UCLASS()
+class SLIME_API UFireLatencySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** The subsystem of WorldContextObject's world, or null if recording is off. */
+	static UFireLatencySubsystem* Get(const UObject* WorldContextObject);
+
+	FORCEINLINE static double Now() { return FPlatformTime::Seconds(); }
+
+	/** Records the time from StartSeconds to now. Does nothing if StartSeconds is 0, i.e. the stage isn't pending. */
+	void Record(EFireLatencyStage Stage, double StartSeconds);
+
+	FORCEINLINE const FFireLatencyHistogram& GetHistogram(EFireLatencyStage Stage) const { return Histograms[static_cast<int32>(Stage)]; }
+
+	static const TCHAR* GetStageName(EFireLatencyStage Stage);
+
+	/** Logs count, mean, min, max and percentiles of every stage. */
+	void Dump() const;
+
+	void Reset();
+
+	/** Writes a row per stage with its summary and bucket counts. Returns false if the file couldn't be written. */
+	bool WriteCSV(const FString& Filename) const;
+
+private:
+	FFireLatencyHistogram Histograms[static_cast<int32>(EFireLatencyStage::MAX)];
+};
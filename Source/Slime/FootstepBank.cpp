@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FootstepBank.h"
+
+void UFootstepBank::PostLoad()
+{
+	Super::PostLoad();
+
+	RebuildSoundBySurface();
+}
+
+#if WITH_EDITOR
+void UFootstepBank::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildSoundBySurface();
+}
+#endif
+
+void UFootstepBank::RebuildSoundBySurface()
+{
+	SoundBySurface.Init(nullptr, SurfaceType_Max);
+	for (const TPair<TEnumAsByte<EPhysicalSurface>, USoundBase*>& Entry : Sounds)
+	{
+		SoundBySurface[Entry.Key.GetValue()] = Entry.Value;
+	}
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
+#include "FootstepBank.generated.h"
+
+class USoundBase;
+
+/**
+ * Footstep sound of each physical surface. Edited as a map, and flattened into an array indexed by EPhysicalSurface
+ * on load, so a footstep costs one array read.
+ */
+UCLASS(BlueprintType)
+class SLIME_API UFootstepBank : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** The surface's sound, or DefaultSound if it has none. */
+	FORCEINLINE USoundBase* GetSound(EPhysicalSurface Surface) const
+	{
+		return SoundBySurface.IsValidIndex(Surface) && SoundBySurface[Surface] ? SoundBySurface[Surface] : DefaultSound;
+	}
+
+private:
+	void RebuildSoundBySurface();
+
+	UPROPERTY(EditAnywhere, Category = Footsteps)
+	TMap<TEnumAsByte<EPhysicalSurface>, USoundBase*> Sounds;
+
+	/** Played on surfaces without a sound of their own. */
+	UPROPERTY(EditAnywhere, Category = Footsteps)
+	USoundBase* DefaultSound;
+
+	/** Sounds, indexed by EPhysicalSurface. */
+	UPROPERTY(Transient)
+	TArray<USoundBase*> SoundBySurface;
+};
@@ -4,28 +4,46 @@
 #include "Item.h"
 
 #include "ShooterCharacter.h"
+#include "Ammo.h"
+#include "Weapon.h"
+#include "ItemWorldSubsystem.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
-#include "Components/WidgetComponent.h"
+#include "Components/StaticMeshComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Curves/CurveVector.h"
+#include "Slime.h"
 
-// Sets default values
-AItem::AItem() :
+DECLARE_CYCLE_STAT(TEXT("Item Update Falling"), STAT_ItemUpdateFalling, STATGROUP_Slime);
 
+// Sets default values
+AItem::AItem(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer),
 	InterpolationSpeed(25.f),
 	PulseCurveTime(5.f),
 	GlowAmount(1.5f),
 	FresnelExponent(1.f),
 	FresnelReflectFraction(1.f),
+	PickupWidgetOffset(0.f, 0.f, 60.f),
 	ItemName(FString("Default")),
 	ItemCount(0),
 	ItemRarity(EItemRarity::EIR_Common),
 	ItemState(EItemState::EIS_Pickup),
+	bActivated(false),
+	bDeferActivation(false),
+	SaveId(0),
 	bInterping(false),
 	IterpTimerDuration(0.4f),
+	FallingVelocity(FVector::ZeroVector),
+	FallingSpinRate(0.f),
+	FallingTime(0.f),
+	FallingSweepRadius(8.f),
+	FallingRestitution(0.3f),
+	FallingFriction(0.4f),
+	SettleSpeed(30.f),
+	MaxFallingTime(5.f),
 	ItemType(EItemType::EIT_MAX),
 	MaterialIndex(0),
 	SlotIndex(0),
@@ -35,26 +53,89 @@ AItem::AItem() :
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
-	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
+	// Optional, so subclasses with their own root mesh (e.g. AAmmo) can skip them.
+	ItemMesh = CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	SetRootComponent(ItemMesh);
+	PickupMesh = CreateOptionalDefaultSubobject<UStaticMeshComponent>(TEXT("PickupMesh"));
+	if (PickupMesh)
+	{
+		PickupMesh->SetupAttachment(GetRootComponent());
+		PickupMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		PickupMesh->SetGenerateOverlapEvents(false);
+		PickupMesh->SetVisibility(false);
+	}
+
 	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
 	CollisionBox->SetupAttachment(GetRootComponent());
 	CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
-
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(GetRootComponent());
-	PickupWidget->SetVisibility(false);
-	PickupWidget->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);  // Enabled by SetItemProperties() on activation.
 
 	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
 	AreaSphere->SetupAttachment(GetRootComponent());
+	AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);  // Enabled by SetItemProperties() on activation.
+}
+
+// Spawns a deferred item, so its type and rarity are set before construction applies them.
+AItem* AItem::SpawnItem(UWorld* World, UClass* ItemClass, const FTransform& Transform, const FItemSpawnParams& Params)
+{
+	if (World == nullptr || ItemClass == nullptr) return nullptr;
+
+	AItem* Item = World->SpawnActorDeferred<AItem>(
+		ItemClass,
+		Transform,
+		nullptr,
+		nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Item == nullptr) return nullptr;
+
+	Item->SetItemRarity(Params.Rarity);
+	if (Params.ItemCount != INDEX_NONE)
+	{
+		Item->SetItemCount(Params.ItemCount);
+	}
+	Item->SetSaveId(Params.SaveId);
+	Item->SetDeferActivation(Params.bDeferActivation);
+	if (AWeapon* Weapon = Cast<AWeapon>(Item))
+	{
+		Weapon->SetWeaponType(static_cast<EWeaponType>(Params.SubType));
+	}
+	else if (AAmmo* Ammo = Cast<AAmmo>(Item))
+	{
+		Ammo->SetAmmoType(static_cast<EAmmoType>(Params.SubType));
+	}
+	UGameplayStatics::FinishSpawningActor(Item, Transform);
+	return Item;
 }
 
 // Called when the game starts or when spawned
 void AItem::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (ShouldDeferActivation())
+	{
+		if (UItemWorldSubsystem* ItemSubsystem = GetWorld()->GetSubsystem<UItemWorldSubsystem>())
+		{
+			SetActorTickEnabled(false);
+			ItemSubsystem->QueueActivation(this);
+			return;
+		}
+	}
+	ActivateItem();
+}
+
+bool AItem::ShouldDeferActivation() const
+{
+	// Items saved in the level all begin play in the same frame, so spread them out.
+	return (bDeferActivation || HasAnyFlags(RF_WasLoaded)) && UItemWorldSubsystem::IsActivationDeferralEnabled();
+}
+
+void AItem::ActivateItem()
+{
+	if (bActivated) return;
+	bActivated = true;
+	SetActorTickEnabled(true);
 	
 	// Setup overlap function bindings for AreaSphere
 	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
@@ -66,6 +147,44 @@ void AItem::BeginPlay()
 	// Sets custom depth to disabled.  ToDo: Test moving these into Constructor / SetItemProperties().
 	InitializeCustomDepth();
 	StartPulseTimer();
+
+	UpdateGroundRegistration();
+}
+
+FVector AItem::GetTargetLocation(AActor* RequestedBy) const
+{
+	return CollisionBox ? CollisionBox->Bounds.Origin : Super::GetTargetLocation(RequestedBy);
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemWorldSubsystem* ItemSubsystem = GetWorld()->GetSubsystem<UItemWorldSubsystem>())
+	{
+		ItemSubsystem->UnregisterGroundItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItem::UpdateGroundRegistration()
+{
+	UItemWorldSubsystem* ItemSubsystem{ GetWorld()->GetSubsystem<UItemWorldSubsystem>() };
+	if (ItemSubsystem == nullptr) return;
+
+	if (ItemState == EItemState::EIS_Pickup && !IsPendingKill())
+	{
+		if (!ItemSubsystem->IsGroundItem(this))
+		{
+			ItemSubsystem->RegisterGroundItem(this);
+			OnEnterGround();
+		}
+	}
+	else
+	{
+		ItemSubsystem->UnregisterGroundItem(this);
+		// Ground items may have been slowed down by UShooterSignificanceSubsystem; items in play tick every frame.
+		SetActorTickInterval(0.f);
+	}
 }
 
 void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
@@ -100,10 +219,13 @@ void AItem::SetItemProperties(EItemState State)
 	switch (State)
 	{
 	case EItemState::EIS_Pickup:
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		if (ItemMesh)
+		{
+			ItemMesh->SetSimulatePhysics(false);
+			ItemMesh->SetVisibility(true);
+			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
 
 		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
@@ -114,14 +236,16 @@ void AItem::SetItemProperties(EItemState State)
 		StartPulseTimer();
 		break;
 	case EItemState::EIS_Equipped:
-		PickupWidget->SetVisibility(false);
 		DisableGlowMaterial();
 		DisableCustomDepth();
 
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		if (ItemMesh)
+		{
+			ItemMesh->SetSimulatePhysics(false);
+			ItemMesh->SetVisibility(true);
+			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
 
 		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -130,12 +254,14 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 	case EItemState::EIS_Falling:
-		ItemMesh->SetSimulatePhysics(true);
-		ItemMesh->SetEnableGravity(true);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECR_Block);
+		// Moved kinematically by UpdateFalling(), so no physics body is needed.
+		if (ItemMesh)
+		{
+			ItemMesh->SetSimulatePhysics(false);
+			ItemMesh->SetVisibility(true);
+			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
 
 		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -144,12 +270,13 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 	case EItemState::EIS_EquipInterping:
-		PickupWidget->SetVisibility(false);
-
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		if (ItemMesh)
+		{
+			ItemMesh->SetSimulatePhysics(false);
+			ItemMesh->SetVisibility(true);
+			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
 
 		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -158,12 +285,13 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 	case EItemState::EIS_PickedUp:
-		PickupWidget->SetVisibility(false);
-
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetVisibility(false);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		if (ItemMesh)
+		{
+			ItemMesh->SetSimulatePhysics(false);
+			ItemMesh->SetVisibility(false);
+			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+			ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
 
 		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -174,6 +302,119 @@ void AItem::SetItemProperties(EItemState State)
 
 		default: ;
 	}
+
+	UpdateMeshRepresentation(State);
+}
+
+void AItem::UpdateMeshRepresentation(EItemState State)
+{
+	if (ItemMesh == nullptr || PickupMesh == nullptr || PickupMesh->GetStaticMesh() == nullptr) return;
+
+	// Remember the skeletal asset the first time we are about to release it.
+	if (ItemMesh->SkeletalMesh)
+	{
+		SkeletalMeshAsset = ItemMesh->SkeletalMesh;
+	}
+
+	const bool bUseStaticMesh{ State == EItemState::EIS_Pickup || State == EItemState::EIS_PickedUp || State == EItemState::EIS_Falling };
+	if (bUseStaticMesh)
+	{
+		PickupMesh->SetVisibility(State != EItemState::EIS_PickedUp);
+		if (ItemMesh->SkeletalMesh)
+		{
+			ItemMesh->SetSkeletalMesh(nullptr);
+		}
+		ItemMesh->SetComponentTickEnabled(false);
+	}
+	else
+	{
+		PickupMesh->SetVisibility(false);
+		if (ItemMesh->SkeletalMesh == nullptr && SkeletalMeshAsset)
+		{
+			ItemMesh->SetSkeletalMesh(SkeletalMeshAsset);
+		}
+		ItemMesh->SetComponentTickEnabled(true);
+	}
+}
+
+void AItem::UpdateFalling(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemUpdateFalling);
+
+	FallingTime += DeltaTime;
+	if (FallingTime > MaxFallingTime)
+	{
+		Settle();
+		return;
+	}
+
+	FallingVelocity.Z += GetWorld()->GetGravityZ() * DeltaTime;
+
+	// The sphere sits on top of the item's origin, so the origin ends up on the ground.
+	const FVector SphereOffset{ 0.f, 0.f, FallingSweepRadius };
+	const FCollisionShape Sphere{ FCollisionShape::MakeSphere(FallingSweepRadius) };
+	const FCollisionObjectQueryParams ObjectParams{ ECollisionChannel::ECC_WorldStatic };
+	FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ItemFalling), false, this };
+
+	// A few iterations let the item slide along a surface after hitting it within the same frame.
+	float TimeLeft{ DeltaTime };
+	for (int32 Iteration = 0; Iteration < 3 && TimeLeft > KINDA_SMALL_NUMBER; ++Iteration)
+	{
+		const FVector Start{ GetActorLocation() + SphereOffset };
+		const FVector End{ Start + FallingVelocity * TimeLeft };
+		FHitResult Hit;
+		if (!GetWorld()->SweepSingleByObjectType(Hit, Start, End, FQuat::Identity, ObjectParams, Sphere, QueryParams))
+		{
+			SetActorLocation(End - SphereOffset);
+			break;
+		}
+
+		if (Hit.bStartPenetrating)
+		{
+			// Thrown from inside geometry, push out and try again.
+			AddActorWorldOffset(Hit.Normal * (Hit.PenetrationDepth + KINDA_SMALL_NUMBER));
+			continue;
+		}
+
+		SetActorLocation(Hit.Location - SphereOffset);
+		TimeLeft *= 1.f - Hit.Time;
+
+		// Bounce off the surface and lose some speed along it.
+		const FVector NormalVelocity{ (FallingVelocity | Hit.ImpactNormal) * Hit.ImpactNormal };
+		const FVector TangentVelocity{ FallingVelocity - NormalVelocity };
+		FallingVelocity = TangentVelocity * (1.f - FallingFriction) - NormalVelocity * FallingRestitution;
+		FallingSpinRate *= 1.f - FallingFriction;
+
+		const bool bWalkable{ Hit.ImpactNormal.Z > 0.7f };
+		if (bWalkable && FallingVelocity.SizeSquared() < FMath::Square(SettleSpeed))
+		{
+			Settle();
+			return;
+		}
+	}
+
+	if (FallingSpinRate != 0.f)
+	{
+		AddActorWorldRotation(FRotator(0.f, FallingSpinRate * DeltaTime, 0.f));
+	}
+}
+
+void AItem::Settle()
+{
+	FallingVelocity = FVector::ZeroVector;
+	FallingSpinRate = 0.f;
+
+	// Rest upright, keeping only the yaw.
+	SetActorRotation(FRotator(0.f, GetActorRotation().Yaw, 0.f));
+	SetItemState(EItemState::EIS_Pickup);
+}
+
+void AItem::Launch(const FVector& Velocity, float SpinRate)
+{
+	FallingVelocity = Velocity;
+	FallingSpinRate = SpinRate;
+	FallingTime = 0.f;
+	SetItemState(EItemState::EIS_Falling);
 }
 
 void AItem::FinishIterping()
@@ -209,12 +450,26 @@ void AItem::ItemInterping(float DeltaTime)
 
 void AItem::EnableCustomDepth()
 {
-	ItemMesh->SetRenderCustomDepth(true);
+	if (ItemMesh)
+	{
+		ItemMesh->SetRenderCustomDepth(true);
+	}
+	if (PickupMesh)
+	{
+		PickupMesh->SetRenderCustomDepth(true);
+	}
 }
 
 void AItem::DisableCustomDepth()
 {
-	ItemMesh->SetRenderCustomDepth(false);
+	if (ItemMesh)
+	{
+		ItemMesh->SetRenderCustomDepth(false);
+	}
+	if (PickupMesh)
+	{
+		PickupMesh->SetRenderCustomDepth(false);
+	}
 }
 
 void AItem::InitializeCustomDepth()
@@ -225,34 +480,29 @@ void AItem::InitializeCustomDepth()
 void AItem::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
-	
-	// Load data from ItemRarity DataTable set in Editor.
-	FString RarityTablePath(TEXT("DataTable'/Game/_Game/DataTable/ItemRarity_DataTable.ItemRarity_DataTable'"));
-	UDataTable* RarityTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *RarityTablePath));
+	ApplyRarityData();
+}
+
+void AItem::ApplyRarityData()
+{
+	// Re-applied whenever an equipped weapon is re-skinned, so the table is only loaded again after a GC took it.
+	static TWeakObjectPtr<UDataTable> CachedRarityTable;
+	UDataTable* RarityTableObject{ CachedRarityTable.Get() };
+	if (RarityTableObject == nullptr)
+	{
+		const TCHAR* RarityTablePath{ TEXT("DataTable'/Game/_Game/DataTable/ItemRarity_DataTable.ItemRarity_DataTable'") };
+		RarityTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, RarityTablePath));
+		CachedRarityTable = RarityTableObject;
+	}
 	if (RarityTableObject)
 	{
-		FItemRarityTable* RarityRow = nullptr;
-		switch (ItemRarity)
-		{
-		case EItemRarity::EIR_Worthless:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Worthless"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Damaged:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Common:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Uncommon:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Rare:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Legendary:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-			break;
-		}
+		// One row per EItemRarity, in declaration order.
+		static const FName RarityRows[]{
+			TEXT("Worthless"), TEXT("Damaged"), TEXT("Common"), TEXT("Uncommon"), TEXT("Rare"), TEXT("Legendary") };
+		const int32 RarityIndex{ static_cast<int32>(ItemRarity) };
+		const FItemRarityTable* RarityRow{ RarityIndex < static_cast<int32>(UE_ARRAY_COUNT(RarityRows))
+			? RarityTableObject->FindRow<FItemRarityTable>(RarityRows[RarityIndex], TEXT(""))
+			: nullptr };
 		if (RarityRow)
 		{
 			GlowColor = RarityRow->GlowColor;
@@ -264,16 +514,38 @@ void AItem::OnConstruction(const FTransform& Transform)
 			{
 				GetItemMesh()->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
 			}
+			if (PickupMesh)
+			{
+				PickupMesh->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
+			}
 		}
 	}
 	if (MaterialInstance)
 	{
-		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
+		// Reused when an equipped weapon is re-skinned, recreated if the material changed in the editor.
+		if (DynamicMaterialInstance == nullptr || DynamicMaterialInstance->Parent != MaterialInstance)
+		{
+			DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
+		}
 		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
-		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
-		EnableGlowMaterial();
+		if (ItemMesh)
+		{
+			ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		}
+		if (PickupMesh)
+		{
+			PickupMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		}
+		// The held weapon doesn't glow; see SetItemProperties().
+		if (ItemState == EItemState::EIS_Equipped)
+		{
+			DisableGlowMaterial();
+		}
+		else
+		{
+			EnableGlowMaterial();
+		}
 	}
-
 }
 
 void AItem::EnableGlowMaterial()
@@ -297,6 +569,10 @@ void AItem::DisableGlowMaterial()
 void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	if (ItemState == EItemState::EIS_Falling)
+	{
+		UpdateFalling(DeltaTime);
+	}
 	ItemInterping(DeltaTime);
 	UpdatePulse();  // Comment says not in use - test this and remove if true.
 }
@@ -305,6 +581,12 @@ void AItem::SetItemState(const EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(State);
+
+	// ActivateItem() registers items that start on the ground.
+	if (bActivated)
+	{
+		UpdateGroundRegistration();
+	}
 }
 
 void AItem::BeginEquip(AShooterCharacter* InstigatingCharacter)
@@ -65,6 +65,23 @@ struct FItemRarityTable : public FTableRowBase
 	int32 CustomDepthStencil;
 };
 
+/** What AItem::SpawnItem() sets on a new item before its construction script runs. */
+struct FItemSpawnParams
+{
+	EItemRarity Rarity{ EItemRarity::EIR_Common };
+
+	/** INDEX_NONE keeps the class default. */
+	int32 ItemCount{ INDEX_NONE };
+
+	/** EWeaponType of a weapon or EAmmoType of ammo, as item placements and saves store it. Ignored by other items. */
+	uint8 SubType{ 0 };
+
+	uint32 SaveId{ 0 };
+
+	/** Leaves binding overlaps to the UItemWorldSubsystem's activation queue, see AItem::SetDeferActivation(). */
+	bool bDeferActivation{ false };
+};
+
 UCLASS()
 class SLIME_API AItem : public AActor
 {
@@ -72,12 +89,29 @@ class SLIME_API AItem : public AActor
 	
 public:	
 	// Sets default values for this actor's properties
-	AItem();
+	AItem(const FObjectInitializer& ObjectInitializer);
+
+	/**
+	 * Spawns an item of ItemClass set up from Params. The spawn is deferred, so type and rarity are in place before
+	 * OnConstruction() loads their data tables; every system that spawns items from data goes through here.
+	 */
+	static AItem* SpawnItem(UWorld* World, UClass* ItemClass, const FTransform& Transform, const FItemSpawnParams& Params);
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** True when BeginPlay() should leave activation to the UItemWorldSubsystem's time-sliced queue. */
+	bool ShouldDeferActivation() const;
+
+	/** Adds the item to, or removes it from, the UItemWorldSubsystem ground grid based on its state. */
+	void UpdateGroundRegistration();
+
+	/** Called when the item starts lying on the ground, after it was added to the ground grid. */
+	virtual void OnEnterGround() {}
+
 	UFUNCTION()
 	void OnSphereOverlap(
 		UPrimitiveComponent* OverlappedComponent, 
@@ -97,6 +131,18 @@ protected:
 	/** Sets properties of item components based on current state. */
 	virtual void SetItemProperties(EItemState State);
 
+	/**
+	 * Swaps between the static Pickup Mesh and the skeletal Item Mesh based on state.
+	 * While the static mesh is shown, the skeletal mesh asset is cleared so the item pays for no bones, skeletal tick or physics asset.
+	 */
+	void UpdateMeshRepresentation(EItemState State);
+
+	/** Moves a falling item under gravity, sweeping a sphere against world static, and settles it once it comes to rest. */
+	void UpdateFalling(float DeltaTime);
+
+	/** Ends the fall and returns the item to the Pickup state. */
+	virtual void Settle();
+
 	/** Called when ItemIterpTimer is finished. */
 	void FinishIterping();
 
@@ -111,6 +157,9 @@ protected:
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	/** Loads colors, stars and stencil for ItemRarity from the rarity data table, and applies them to the glow material. */
+	void ApplyRarityData();
+
 
 	/** Not used FX code.  If possible, test removing this section. */
 	void EnableGlowMaterial();	
@@ -143,18 +192,29 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	/** Center of the CollisionBox, which item targeting aims at. */
+	virtual FVector GetTargetLocation(AActor* RequestedBy = nullptr) const override;
+
 private:
 	/** Line trace collides with box to show HUD widgets. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* CollisionBox;
 
-	/** Item skeletal mesh. */
+	/** Item skeletal mesh. Only holds a mesh asset while the item is equipped or equipping - see UpdateMeshRepresentation(). */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	USkeletalMeshComponent* ItemMesh;
 
-	/** Pop up widget for when player looks at item. */
+	/** Cheap static stand-in for the Item Mesh, used while on the ground or falling. Leave the mesh empty to always use the Item Mesh. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* PickupMesh;
+
+	/** Skeletal mesh asset swapped back into the Item Mesh when the item is equipped. */
+	UPROPERTY(Transient)
+	USkeletalMesh* SkeletalMeshAsset;
+
+	/** Where the character's shared pickup widget is placed, relative to the item's location. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class UWidgetComponent* PickupWidget;
+	FVector PickupWidgetOffset;
 
 	/** Enables item trace when overlapped. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
@@ -175,6 +235,15 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	EItemState ItemState;
 
+	/** False until ActivateItem() has run. Inactive items have no collision, overlap bindings or tick. */
+	bool bActivated;
+
+	/** Defer activation even though the item was spawned at runtime. Set before FinishSpawning(). */
+	bool bDeferActivation;
+
+	/** Identifies the item across saves, so a save can store only what changed. Zero until it is first saved. */
+	uint32 SaveId;
+
 	/** True during interpolation. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	bool bInterping;
@@ -186,6 +255,35 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float IterpTimerDuration;
 	
+	/** Velocity of the kinematic fall while in the Falling state. */
+	FVector FallingVelocity;
+
+	/** Yaw spin while falling, in deg/sec. */
+	float FallingSpinRate;
+
+	/** Time spent in the Falling state, used to force a settle if the item never comes to rest. */
+	float FallingTime;
+
+	/** Radius of the sphere swept against world static while falling, placed just above the item's origin. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties|Falling", meta = (AllowPrivateAccess = "true", ClampMin = "1.0"))
+	float FallingSweepRadius;
+
+	/** Fraction of the velocity into a surface kept as bounce. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties|Falling", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0"))
+	float FallingRestitution;
+
+	/** Fraction of the velocity along a surface lost on each contact. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties|Falling", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0"))
+	float FallingFriction;
+
+	/** Below this speed, an item resting on walkable ground is settled. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties|Falling", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float SettleSpeed;
+
+	/** Items still falling after this long are settled where they are. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties|Falling", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float MaxFallingTime;
+
 	/** Pointer to the character. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class AShooterCharacter* Character;
@@ -234,10 +332,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	bool bWidgetTextIsSwap;
 
-	/** Item rarity row base. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	class UDataTable* ItemRarityDataTable;
-
 	/** Pickup Widget rarity properties based on DataTable set in Editor.*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Rarity, meta = (AllowPrivateAccess = "true"))
 	FLinearColor GlowColor;
@@ -259,19 +353,39 @@ private:
 
 // Getters and Setters.
 public:
-	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
+	FORCEINLINE FVector GetPickupWidgetLocation() const { return GetActorLocation() + PickupWidgetOffset; }
+	FORCEINLINE const FString& GetItemName() const { return ItemName; }
+	FORCEINLINE EItemType GetItemType() const { return ItemType; }
+	FORCEINLINE int32 GetNumberOfStars() const { return NumberOfStars; }
+	FORCEINLINE UTexture2D* GetIconBackground() const { return IconBackground; }
+	FORCEINLINE UTexture2D* GetIconImage() const { return IconImage; }
+	FORCEINLINE UTexture2D* GetAmmoIcon() const { return AmmoIcon; }
+	FORCEINLINE bool GetWidgetTextIsSwap() const { return bWidgetTextIsSwap; }
 	FORCEINLINE USphereComponent* GetAreaSphere() const { return AreaSphere; }
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox;  }
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 	void SetItemState(const EItemState State);
+	/** Puts the item in the Falling state and moves it kinematically from the given velocity until it settles. No physics body is created. */
+	void Launch(const FVector& Velocity, float SpinRate = 0.f);
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
-	void BeginEquip(AShooterCharacter* InstigatingCharacter);
+	FORCEINLINE UStaticMeshComponent* GetPickupMesh() const { return PickupMesh; }
+	virtual void BeginEquip(AShooterCharacter* InstigatingCharacter);
+	/** Binds overlaps and applies the item state. Called from BeginPlay(), or later by the UItemWorldSubsystem when deferred. */
+	virtual void ActivateItem();
+	FORCEINLINE bool IsActivated() const { return bActivated; }
+	FORCEINLINE void SetDeferActivation(const bool bDefer) { bDeferActivation = bDefer; }
+	FORCEINLINE uint32 GetSaveId() const { return SaveId; }
+	FORCEINLINE void SetSaveId(const uint32 Id) { SaveId = Id; }
 	FORCEINLINE USoundCue* GetPickupSound() const { return PickupSound; }
 	FORCEINLINE void SetPickupSound(USoundCue* Sound) { PickupSound = Sound; }
 	FORCEINLINE USoundCue* GetEquipSound() const { return EquipSound; }
 	FORCEINLINE void SetEquipSound(USoundCue* Sound) { EquipSound = Sound; }
 	FORCEINLINE bool IsInterping() const { return bInterping; }
 	FORCEINLINE int32 GetItemCount() const { return ItemCount;  }
+	FORCEINLINE void SetItemCount(const int32 Count) { ItemCount = Count; }
+	FORCEINLINE EItemRarity GetItemRarity() const { return ItemRarity; }
+	/** Only meaningful before construction scripts run (e.g. deferred spawning), since rarity data is loaded in OnConstruction(). See also AWeapon::ApplyInstanceRecord(). */
+	FORCEINLINE void SetItemRarity(const EItemRarity Rarity) { ItemRarity = Rarity; }
 	virtual void EnableCustomDepth();
 	virtual void DisableCustomDepth();
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
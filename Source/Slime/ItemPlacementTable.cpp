@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPlacementTable.h"
+
+#include "Slime.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+
+FItemPlacementTable::~FItemPlacementTable()
+{
+	Close();
+}
+
+bool FItemPlacementTable::Open(const FString& Filename)
+{
+	Close();
+
+	const uint8* Data{ nullptr };
+	int64 Size{ 0 };
+
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedHandle)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion());
+	}
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Data = FileData.GetData();
+		Size = FileData.Num();
+	}
+
+	auto Fail = [this, &Filename](const TCHAR* Reason)
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Item placement table %s is invalid: %s"), *Filename, Reason);
+		Close();
+		return false;
+	};
+
+	if (Size < static_cast<int64>(sizeof(FItemPlacementHeader))) return Fail(TEXT("truncated header"));
+
+	const FItemPlacementHeader* FileHeader{ reinterpret_cast<const FItemPlacementHeader*>(Data) };
+	if (FileHeader->Magic != FItemPlacementHeader::ExpectedMagic) return Fail(TEXT("bad magic"));
+	if (FileHeader->Version != FItemPlacementHeader::CurrentVersion) return Fail(TEXT("unsupported version"));
+	if (FileHeader->CellSize <= 0.f) return Fail(TEXT("bad cell size"));
+	if (FileHeader->CellTableOffset + static_cast<int64>(FileHeader->NumCells) * sizeof(FItemPlacementCell) > Size ||
+		FileHeader->RecordOffset + static_cast<int64>(FileHeader->NumRecords) * sizeof(FItemPlacementRecord) > Size)
+	{
+		return Fail(TEXT("truncated tables"));
+	}
+
+	// Class paths are few, so copy them out instead of handing out views into the file.
+	int64 Offset{ FileHeader->ClassTableOffset };
+	ClassPaths.Reserve(FileHeader->NumClasses);
+	for (uint32 i = 0; i < FileHeader->NumClasses; ++i)
+	{
+		if (Offset + static_cast<int64>(sizeof(uint16)) > Size) return Fail(TEXT("truncated class table"));
+		const uint16 Length{ *reinterpret_cast<const uint16*>(Data + Offset) };
+		Offset += sizeof(uint16);
+		if (Offset + Length > Size) return Fail(TEXT("truncated class table"));
+		const FUTF8ToTCHAR Path(reinterpret_cast<const ANSICHAR*>(Data + Offset), Length);
+		ClassPaths.Add(FString(Path.Length(), Path.Get()));
+		Offset = Align(Offset + Length, 4);
+	}
+
+	Header = FileHeader;
+	Cells = reinterpret_cast<const FItemPlacementCell*>(Data + FileHeader->CellTableOffset);
+	Records = reinterpret_cast<const FItemPlacementRecord*>(Data + FileHeader->RecordOffset);
+
+	for (const FItemPlacementCell& Cell : GetCells())
+	{
+		if (Cell.FirstRecord + static_cast<uint64>(Cell.NumRecords) > Header->NumRecords) return Fail(TEXT("cell out of range"));
+	}
+	return true;
+}
+
+void FItemPlacementTable::Close()
+{
+	Header = nullptr;
+	Cells = nullptr;
+	Records = nullptr;
+	ClassPaths.Empty();
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	FileData.Empty();
+}
+
+int32 FItemPlacementTable::FindCell(const FIntPoint& Cell) const
+{
+	if (!IsOpen()) return INDEX_NONE;
+
+	const int32 Index{ static_cast<int32>(Algo::LowerBound(GetCells(), Cell, [](const FItemPlacementCell& Entry, const FIntPoint& Key)
+	{
+		return Entry.X < Key.X || (Entry.X == Key.X && Entry.Y < Key.Y);
+	})) };
+
+	if (Index < static_cast<int32>(Header->NumCells) && Cells[Index].X == Cell.X && Cells[Index].Y == Cell.Y)
+	{
+		return Index;
+	}
+	return INDEX_NONE;
+}
+
+TArrayView<const FItemPlacementRecord> FItemPlacementTable::GetCellRecords(int32 CellIndex) const
+{
+	const FItemPlacementCell& Cell{ Cells[CellIndex] };
+	return MakeArrayView(Records + Cell.FirstRecord, Cell.NumRecords);
+}
+
+FIntPoint FItemPlacementTable::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / Header->CellSize),
+		FMath::FloorToInt(Location.Y / Header->CellSize));
+}
+
+bool FItemPlacementTable::Write(const FString& Filename, float CellSize, const TArray<FItemPlacement>& Placements)
+{
+	if (CellSize <= 0.f) return false;
+
+	// Class path table.
+	TArray<FString> ClassPaths;
+	TArray<uint8> ClassTable;
+	for (const FItemPlacement& Placement : Placements)
+	{
+		if (ClassPaths.Contains(Placement.ClassPath)) continue;
+
+		ClassPaths.Add(Placement.ClassPath);
+		const FTCHARToUTF8 Path(*Placement.ClassPath);
+		const uint16 Length{ static_cast<uint16>(Path.Length()) };
+		ClassTable.Append(reinterpret_cast<const uint8*>(&Length), sizeof(Length));
+		ClassTable.Append(reinterpret_cast<const uint8*>(Path.Get()), Length);
+		ClassTable.SetNumZeroed(Align(ClassTable.Num(), 4));
+	}
+	if (ClassPaths.Num() > TNumericLimits<uint16>::Max()) return false;
+
+	// Group by cell, in directory order.
+	struct FSortedPlacement
+	{
+		FIntPoint Cell;
+		const FItemPlacement* Placement;
+	};
+	TArray<FSortedPlacement> Sorted;
+	Sorted.Reserve(Placements.Num());
+	for (const FItemPlacement& Placement : Placements)
+	{
+		const FIntPoint Cell(FMath::FloorToInt(Placement.Location.X / CellSize), FMath::FloorToInt(Placement.Location.Y / CellSize));
+		Sorted.Add(FSortedPlacement{ Cell, &Placement });
+	}
+	Sorted.StableSort([](const FSortedPlacement& A, const FSortedPlacement& B)
+	{
+		return A.Cell.X < B.Cell.X || (A.Cell.X == B.Cell.X && A.Cell.Y < B.Cell.Y);
+	});
+
+	TArray<FItemPlacementCell> CellTable;
+	TArray<FItemPlacementRecord> RecordTable;
+	RecordTable.Reserve(Sorted.Num());
+	for (const FSortedPlacement& Entry : Sorted)
+	{
+		if (CellTable.Num() == 0 || CellTable.Last().X != Entry.Cell.X || CellTable.Last().Y != Entry.Cell.Y)
+		{
+			CellTable.Add(FItemPlacementCell{ Entry.Cell.X, Entry.Cell.Y, static_cast<uint32>(RecordTable.Num()), 0 });
+		}
+		++CellTable.Last().NumRecords;
+
+		FItemPlacementRecord& Record{ RecordTable.AddZeroed_GetRef() };
+		Record.Location = Entry.Placement->Location;
+		Record.ClassIndex = static_cast<uint16>(ClassPaths.IndexOfByKey(Entry.Placement->ClassPath));
+		Record.Yaw = FItemPlacementRecord::QuantizeYaw(Entry.Placement->Yaw);
+		Record.Count = static_cast<uint16>(FMath::Clamp(Entry.Placement->Count, 0, static_cast<int32>(TNumericLimits<uint16>::Max())));
+		Record.Rarity = Entry.Placement->Rarity;
+		Record.SubType = Entry.Placement->SubType;
+	}
+
+	FItemPlacementHeader FileHeader;
+	FileHeader.Magic = FItemPlacementHeader::ExpectedMagic;
+	FileHeader.Version = FItemPlacementHeader::CurrentVersion;
+	FileHeader.CellSize = CellSize;
+	FileHeader.NumClasses = ClassPaths.Num();
+	FileHeader.NumCells = CellTable.Num();
+	FileHeader.NumRecords = RecordTable.Num();
+	FileHeader.ClassTableOffset = sizeof(FItemPlacementHeader);
+	FileHeader.CellTableOffset = FileHeader.ClassTableOffset + ClassTable.Num();
+	FileHeader.RecordOffset = FileHeader.CellTableOffset + CellTable.Num() * sizeof(FItemPlacementCell);
+
+	TArray<uint8> FileData;
+	FileData.Reserve(FileHeader.RecordOffset + RecordTable.Num() * sizeof(FItemPlacementRecord));
+	FileData.Append(reinterpret_cast<const uint8*>(&FileHeader), sizeof(FileHeader));
+	FileData.Append(ClassTable);
+	FileData.Append(reinterpret_cast<const uint8*>(CellTable.GetData()), CellTable.Num() * sizeof(FItemPlacementCell));
+	FileData.Append(reinterpret_cast<const uint8*>(RecordTable.GetData()), RecordTable.Num() * sizeof(FItemPlacementRecord));
+
+	return FFileHelper::SaveArrayToFile(FileData, *Filename);
+}
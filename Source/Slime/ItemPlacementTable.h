@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Binary item placement table, written by the editor export (slime.Items.ExportPlacements) and memory mapped at runtime.
+ *
+ * Layout, all little-endian and 4 byte aligned:
+ *   FItemPlacementHeader
+ *   Class table: per class, a uint16 length and that many UTF-8 chars of the class path, padded to 4 bytes
+ *   Cell directory: FItemPlacementCell[NumCells], sorted by (X, Y)
+ *   Records: FItemPlacementRecord[NumRecords], grouped by cell
+ */
+struct FItemPlacementHeader
+{
+	static constexpr uint32 ExpectedMagic{ 0x534C4950 };  // 'SLIP'
+	static constexpr uint32 CurrentVersion{ 1 };
+
+	uint32 Magic;
+	uint32 Version;
+	float CellSize;
+	uint32 NumClasses;
+	uint32 NumCells;
+	uint32 NumRecords;
+	uint32 ClassTableOffset;
+	uint32 CellTableOffset;
+	uint32 RecordOffset;
+};
+
+/** One grid cell's range in the record array. */
+struct FItemPlacementCell
+{
+	int32 X;
+	int32 Y;
+	uint32 FirstRecord;
+	uint32 NumRecords;
+};
+
+/** One placed item. 20 bytes, versus a full actor and its components in the level package. */
+struct FItemPlacementRecord
+{
+	FVector Location;
+	uint16 ClassIndex;
+	/** Yaw quantized to 65536 steps. Items on the ground only ever rotate around Z. */
+	uint16 Yaw;
+	uint16 Count;
+	/** EItemRarity. */
+	uint8 Rarity;
+	/** EWeaponType for weapons, EAmmoType for ammo. */
+	uint8 SubType;
+
+	FORCEINLINE float GetYaw() const { return Yaw * (360.f / 65536.f); }
+	FORCEINLINE static uint16 QuantizeYaw(const float InYaw) { return static_cast<uint16>(FMath::RoundToInt(FRotator::ClampAxis(InYaw) * (65536.f / 360.f)) & 0xFFFF); }
+};
+
+static_assert(sizeof(FItemPlacementHeader) == 36, "Item placement header layout changed, bump CurrentVersion.");
+static_assert(sizeof(FItemPlacementCell) == 16, "Item placement cell layout changed, bump CurrentVersion.");
+static_assert(sizeof(FItemPlacementRecord) == 20, "Item placement record layout changed, bump CurrentVersion.");
+
+/** An item placement before it is packed, as gathered by the export. */
+struct FItemPlacement
+{
+	FString ClassPath;
+	FVector Location;
+	float Yaw;
+	int32 Count;
+	uint8 Rarity;
+	uint8 SubType;
+};
+
+/**
+ * Read-only view of an item placement file. The file is memory mapped where the platform supports it
+ * (loose files only, so stage the directory as non-UFS), and read into memory otherwise.
+ */
+class SLIME_API FItemPlacementTable
+{
+public:
+	FItemPlacementTable() = default;
+	~FItemPlacementTable();
+
+	FItemPlacementTable(const FItemPlacementTable&) = delete;
+	FItemPlacementTable& operator=(const FItemPlacementTable&) = delete;
+
+	/** Maps the file and validates its header. Returns false, and stays closed, if the file is missing or malformed. */
+	bool Open(const FString& Filename);
+	void Close();
+
+	FORCEINLINE bool IsOpen() const { return Header != nullptr; }
+	FORCEINLINE float GetCellSize() const { return Header->CellSize; }
+	FORCEINLINE int32 GetNumRecords() const { return Header->NumRecords; }
+	FORCEINLINE const TArray<FString>& GetClassPaths() const { return ClassPaths; }
+	FORCEINLINE TArrayView<const FItemPlacementCell> GetCells() const { return MakeArrayView(Cells, Header->NumCells); }
+
+	/** Index into the cell directory, or INDEX_NONE if the cell is empty. */
+	int32 FindCell(const FIntPoint& Cell) const;
+
+	/** Records of a cell from the directory. */
+	TArrayView<const FItemPlacementRecord> GetCellRecords(int32 CellIndex) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Packs the placements into a file, grouped by cells of CellSize. */
+	static bool Write(const FString& Filename, float CellSize, const TArray<FItemPlacement>& Placements);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Used when the file can't be mapped. */
+	TArray<uint8> FileData;
+
+	const FItemPlacementHeader* Header{ nullptr };
+	const FItemPlacementCell* Cells{ nullptr };
+	const FItemPlacementRecord* Records{ nullptr };
+	TArray<FString> ClassPaths;
+};
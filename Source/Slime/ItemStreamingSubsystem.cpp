@@ -0,0 +1,369 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemStreamingSubsystem.h"
+
+#include "Ammo.h"
+#include "Item.h"
+#include "Slime.h"
+#include "Weapon.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Streaming Tick"), STAT_ItemStreamingTick, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Streamed Item Cells"), STAT_StreamedItemCells, STATGROUP_Slime);
+
+static TAutoConsoleVariable<float> CVarItemStreamRadius(
+	TEXT("slime.Items.StreamRadius"),
+	5000.f,
+	TEXT("Placed items in grid cells within this distance of a player pawn are spawned."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarItemStreamReleaseRadius(
+	TEXT("slime.Items.StreamReleaseRadius"),
+	6000.f,
+	TEXT("Streamed cells farther than this from every player pawn are released. Keep above StreamRadius so cells at the edge don't thrash."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarItemStreamInterval(
+	TEXT("slime.Items.StreamInterval"),
+	0.25f,
+	TEXT("Seconds between checks for item cells to stream in or out."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarItemStreamSpawnBudgetMs(
+	TEXT("slime.Items.StreamSpawnBudgetMs"),
+	1.f,
+	TEXT("Game thread time per frame spent spawning streamed items. At least one item is spawned per frame."),
+	ECVF_Default);
+
+#if WITH_EDITOR
+static TAutoConsoleVariable<float> CVarItemPlacementCellSize(
+	TEXT("slime.Items.PlacementCellSize"),
+	2000.f,
+	TEXT("Grid cell size used by slime.Items.ExportPlacements."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs ExportItemPlacementsCommand(
+	TEXT("slime.Items.ExportPlacements"),
+	TEXT("Writes every item lying in the level to the map's item placement table. Pass 'remove' to also delete the exported actors from the level."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		const bool bRemove{ Args.Contains(TEXT("remove")) && !World->IsGameWorld() };
+		TArray<FItemPlacement> Placements;
+		TArray<AItem*> Exported;
+		for (TActorIterator<AItem> It(World); It; ++It)
+		{
+			AItem* Item{ *It };
+			if (Item->GetItemState() != EItemState::EIS_Pickup || Item->GetOwner() != nullptr) continue;
+
+			FItemPlacement& Placement{ Placements.AddDefaulted_GetRef() };
+			Placement.ClassPath = Item->GetClass()->GetPathName();
+			Placement.Location = Item->GetActorLocation();
+			Placement.Yaw = Item->GetActorRotation().Yaw;
+			Placement.Count = Item->GetItemCount();
+			Placement.Rarity = static_cast<uint8>(Item->GetItemRarity());
+			Placement.SubType = 0;
+			if (const AWeapon* Weapon = Cast<AWeapon>(Item))
+			{
+				Placement.SubType = static_cast<uint8>(Weapon->GetWeaponType());
+			}
+			else if (const AAmmo* Ammo = Cast<AAmmo>(Item))
+			{
+				Placement.SubType = static_cast<uint8>(Ammo->GetAmmoType());
+			}
+			Exported.Add(Item);
+		}
+
+		const FString Filename{ UItemStreamingSubsystem::GetPlacementFilename(World) };
+		if (!FItemPlacementTable::Write(Filename, CVarItemPlacementCellSize.GetValueOnGameThread(), Placements))
+		{
+			UE_LOG(LogSlime, Error, TEXT("Failed to write item placement table %s"), *Filename);
+			return;
+		}
+		UE_LOG(LogSlime, Display, TEXT("Exported %d item placements to %s"), Placements.Num(), *Filename);
+
+		if (bRemove)
+		{
+			for (AItem* Item : Exported)
+			{
+				World->EditorDestroyActor(Item, true);
+			}
+			World->MarkPackageDirty();
+		}
+	}));
+#endif
+
+void UItemStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!GetWorld()->IsGameWorld()) return;
+
+	const FString Filename{ GetPlacementFilename(GetWorld()) };
+	if (!Table.Open(Filename)) return;
+
+	// Only a handful of item classes, loaded once.
+	for (const FString& ClassPath : Table.GetClassPaths())
+	{
+		UClass* ItemClass{ StaticLoadClass(AItem::StaticClass(), nullptr, *ClassPath) };
+		if (ItemClass == nullptr)
+		{
+			UE_LOG(LogSlime, Warning, TEXT("Item placement class %s failed to load, its placements are skipped."), *ClassPath);
+		}
+		RecordClasses.Add(ItemClass);
+	}
+	ConsumedRecords.Init(false, Table.GetNumRecords());
+
+	UE_LOG(LogSlime, Log, TEXT("Streaming %d item placements in %d cells from %s"),
+		Table.GetNumRecords(),
+		Table.GetCells().Num(),
+		*Filename);
+}
+
+void UItemStreamingSubsystem::Deinitialize()
+{
+	LoadedCells.Empty();
+	PendingCells.Empty();
+	RecordClasses.Empty();
+	ConsumedRecords.Empty();
+	Table.Close();
+
+	Super::Deinitialize();
+}
+
+FString UItemStreamingSubsystem::GetPlacementFilename(const UWorld* World)
+{
+	const FString MapName{ UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost())) };
+	return FPaths::ProjectContentDir() / TEXT("ItemPlacements") / MapName + TEXT(".slip");
+}
+
+int32 UItemStreamingSubsystem::GetNumStreamedItems() const
+{
+	int32 NumItems{ 0 };
+	for (const TPair<FIntPoint, FStreamedCell>& Cell : LoadedCells)
+	{
+		NumItems += Cell.Value.Items.Num();
+	}
+	return NumItems;
+}
+
+void UItemStreamingSubsystem::GetPersistentState(TBitArray<>& OutConsumedRecords, TSet<const AItem*>& OutStreamedItems) const
+{
+	OutConsumedRecords = ConsumedRecords;
+	for (const TPair<FIntPoint, FStreamedCell>& Cell : LoadedCells)
+	{
+		for (const TPair<int32, FStreamedItem>& Entry : Cell.Value.Items)
+		{
+			if (MatchesRecord(Entry.Value))
+			{
+				OutStreamedItems.Add(Entry.Value.Item.Get());
+			}
+			else
+			{
+				// Saved as an ordinary ground item, if it is still lying around.
+				OutConsumedRecords[Entry.Key] = true;
+			}
+		}
+	}
+}
+
+void UItemStreamingSubsystem::RestorePersistentState(const TBitArray<>& InConsumedRecords)
+{
+	if (!Table.IsOpen()) return;
+
+	if (InConsumedRecords.Num() != Table.GetNumRecords())
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Saved item placement state has %d records, the table has %d. The placement table changed since the save, so it is ignored."),
+			InConsumedRecords.Num(),
+			Table.GetNumRecords());
+		return;
+	}
+
+	for (TPair<FIntPoint, FStreamedCell>& Cell : LoadedCells)
+	{
+		ReleaseCell(Cell.Value);
+	}
+	LoadedCells.Empty();
+	PendingCells.Empty();
+	ConsumedRecords = InConsumedRecords;
+
+	// Stream back in on the next tick.
+	TimeSinceCellUpdate = CVarItemStreamInterval.GetValueOnGameThread();
+}
+
+void UItemStreamingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemStreamingTick);
+
+	TimeSinceCellUpdate += DeltaTime;
+	if (TimeSinceCellUpdate >= CVarItemStreamInterval.GetValueOnGameThread())
+	{
+		TimeSinceCellUpdate = 0.f;
+		UpdateCells();
+	}
+
+	if (PendingCells.Num() > 0)
+	{
+		SpawnPendingRecords();
+	}
+}
+
+bool UItemStreamingSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Table.IsOpen();
+}
+
+TStatId UItemStreamingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemStreamingSubsystem, STATGROUP_Tickables);
+}
+
+void UItemStreamingSubsystem::UpdateCells()
+{
+	TArray<FVector2D, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn{ It->IsValid() ? (*It)->GetPawn() : nullptr };
+		if (Pawn == nullptr) continue;
+
+		PlayerLocations.Add(FVector2D(Pawn->GetActorLocation()));
+	}
+
+	const float CellSize{ Table.GetCellSize() };
+	auto DistSquaredToPlayers = [&PlayerLocations, CellSize](const FIntPoint& Cell)
+	{
+		const FBox2D Bounds(FVector2D(Cell) * CellSize, FVector2D(Cell + FIntPoint(1, 1)) * CellSize);
+		float Nearest{ TNumericLimits<float>::Max() };
+		for (const FVector2D& Location : PlayerLocations)
+		{
+			Nearest = FMath::Min(Nearest, Bounds.ComputeSquaredDistanceToPoint(Location));
+		}
+		return Nearest;
+	};
+
+	const float StreamRadius{ CVarItemStreamRadius.GetValueOnGameThread() };
+	const float ReleaseRadius{ FMath::Max(CVarItemStreamReleaseRadius.GetValueOnGameThread(), StreamRadius) };
+
+	for (auto CellIt = LoadedCells.CreateIterator(); CellIt; ++CellIt)
+	{
+		// Items picked up, merged, evicted or restacked belong to the player (or nobody, or the ground) now, not to the cell.
+		for (auto ItemIt = CellIt->Value.Items.CreateIterator(); ItemIt; ++ItemIt)
+		{
+			if (!MatchesRecord(ItemIt->Value))
+			{
+				ConsumedRecords[ItemIt->Key] = true;
+				ItemIt.RemoveCurrent();
+			}
+		}
+
+		if (DistSquaredToPlayers(CellIt->Key) > FMath::Square(ReleaseRadius))
+		{
+			ReleaseCell(CellIt->Value);
+			PendingCells.Remove(CellIt->Key);
+			CellIt.RemoveCurrent();
+		}
+	}
+
+	bool bAddedCells{ false };
+	for (const FVector2D& Location : PlayerLocations)
+	{
+		const int32 MinX{ FMath::FloorToInt((Location.X - StreamRadius) / CellSize) };
+		const int32 MaxX{ FMath::FloorToInt((Location.X + StreamRadius) / CellSize) };
+		const int32 MinY{ FMath::FloorToInt((Location.Y - StreamRadius) / CellSize) };
+		const int32 MaxY{ FMath::FloorToInt((Location.Y + StreamRadius) / CellSize) };
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			for (int32 Y = MinY; Y <= MaxY; ++Y)
+			{
+				const FIntPoint Cell(X, Y);
+				if (LoadedCells.Contains(Cell) || DistSquaredToPlayers(Cell) > FMath::Square(StreamRadius)) continue;
+
+				// Empty cells aren't in the directory, so there is nothing to track for them.
+				const int32 CellIndex{ Table.FindCell(Cell) };
+				if (CellIndex == INDEX_NONE) continue;
+
+				LoadedCells.Add(Cell).CellIndex = CellIndex;
+				PendingCells.Add(Cell);
+				bAddedCells = true;
+			}
+		}
+	}
+
+	if (bAddedCells)
+	{
+		PendingCells.Sort([&DistSquaredToPlayers](const FIntPoint& A, const FIntPoint& B)
+		{
+			return DistSquaredToPlayers(A) < DistSquaredToPlayers(B);
+		});
+	}
+	SET_DWORD_STAT(STAT_StreamedItemCells, LoadedCells.Num());
+}
+
+void UItemStreamingSubsystem::SpawnPendingRecords()
+{
+	RunWithinFrameBudget(FPlatformTime::Seconds(), CVarItemStreamSpawnBudgetMs.GetValueOnGameThread(),
+		[this]() { return PendingCells.Num() > 0; },
+		[this]()
+		{
+			FStreamedCell& Cell{ LoadedCells.FindChecked(PendingCells[0]) };
+			const FItemPlacementCell& Entry{ Table.GetCells()[Cell.CellIndex] };
+			if (Cell.NextRecord >= static_cast<int32>(Entry.NumRecords))
+			{
+				PendingCells.RemoveAt(0);
+				return;
+			}
+
+			const int32 RecordIndex{ static_cast<int32>(Entry.FirstRecord) + Cell.NextRecord };
+			const FItemPlacementRecord& Record{ Table.GetCellRecords(Cell.CellIndex)[Cell.NextRecord++] };
+			if (ConsumedRecords[RecordIndex]) return;
+
+			if (AItem* Item = SpawnRecord(Record))
+			{
+				Cell.Items.Add(RecordIndex, FStreamedItem{ Item, Record.Count });
+			}
+		});
+}
+
+AItem* UItemStreamingSubsystem::SpawnRecord(const FItemPlacementRecord& Record)
+{
+	UClass* ItemClass{ RecordClasses.IsValidIndex(Record.ClassIndex) ? RecordClasses[Record.ClassIndex] : nullptr };
+	if (ItemClass == nullptr) return nullptr;
+
+	const FTransform SpawnTransform{ FRotator(0.f, Record.GetYaw(), 0.f), Record.Location };
+
+	FItemSpawnParams Params;
+	Params.Rarity = static_cast<EItemRarity>(Record.Rarity);
+	Params.ItemCount = Record.Count;
+	Params.SubType = Record.SubType;
+	Params.bDeferActivation = true;
+	return AItem::SpawnItem(GetWorld(), ItemClass, SpawnTransform, Params);
+}
+
+void UItemStreamingSubsystem::ReleaseCell(FStreamedCell& Cell)
+{
+	for (const TPair<int32, FStreamedItem>& Entry : Cell.Items)
+	{
+		if (!MatchesRecord(Entry.Value))
+		{
+			// The cell would bring it back as the record has it, losing the change; the item outlives the cell instead.
+			ConsumedRecords[Entry.Key] = true;
+			continue;
+		}
+		Entry.Value.Item->Destroy();
+	}
+	Cell.Items.Empty();
+}
+
+bool UItemStreamingSubsystem::MatchesRecord(const FStreamedItem& StreamedItem)
+{
+	const AItem* Item{ StreamedItem.Item.Get() };
+	return Item
+		&& Item->GetItemState() == EItemState::EIS_Pickup
+		&& Item->GetItemCount() == StreamedItem.RecordCount;
+}
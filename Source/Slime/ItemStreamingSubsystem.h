@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ItemPlacementTable.h"
+#include "ItemStreamingSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Spawns the items of the map's placement table (see FItemPlacementTable) one grid cell at a time, as players come
+ * within slime.Items.StreamRadius, and destroys them again once every player is slime.Items.StreamReleaseRadius away.
+ * Items picked up or otherwise removed from a streamed cell are remembered, so they don't come back when the cell does.
+ * So are items whose count changed, e.g. an ammo stack that absorbed dropped ammo: the record is consumed, and the item
+ * stays as an ordinary ground item instead of being destroyed with its cell.
+ *
+ * The table is Content/ItemPlacements/<MapName>.slip, written in the editor with slime.Items.ExportPlacements.
+ * Maps without one are unaffected.
+ */
+UCLASS()
+class SLIME_API UItemStreamingSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Where the placement table of the world's map lives. */
+	static FString GetPlacementFilename(const UWorld* World);
+
+	FORCEINLINE int32 GetNumLoadedCells() const { return LoadedCells.Num(); }
+	int32 GetNumStreamedItems() const;
+	FORCEINLINE bool IsStreaming() const { return Table.IsOpen(); }
+
+	/**
+	 * Copies which records have been consumed, counting items that left their cell since the last cell update,
+	 * and collects the items still owned by a cell. Those are rebuilt from the table, so a save can skip them.
+	 */
+	void GetPersistentState(TBitArray<>& OutConsumedRecords, TSet<const AItem*>& OutStreamedItems) const;
+
+	/** Replaces the consumed records and releases every loaded cell, so they stream back in without the consumed items. */
+	void RestorePersistentState(const TBitArray<>& InConsumedRecords);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FStreamedItem
+	{
+		TWeakObjectPtr<AItem> Item;
+		/** Count of the record the item was spawned from. */
+		int32 RecordCount{ 0 };
+	};
+
+	struct FStreamedCell
+	{
+		/** Index into the table's cell directory. */
+		int32 CellIndex{ INDEX_NONE };
+		/** Next record to spawn, while the cell is still loading. */
+		int32 NextRecord{ 0 };
+		/** Items spawned from the cell that are still lying where they were placed, by record index. */
+		TMap<int32, FStreamedItem> Items;
+	};
+
+	/** Loads cells near players, releases cells far from all of them, and forgets items that have left their cell. */
+	void UpdateCells();
+
+	/** Spawns queued cell records until this frame's budget is spent. */
+	void SpawnPendingRecords();
+
+	AItem* SpawnRecord(const FItemPlacementRecord& Record);
+	/** Destroys the cell's items that still match their record; the rest are consumed and left in the world. */
+	void ReleaseCell(FStreamedCell& Cell);
+
+	/** True while the item lies where its record placed it, as the record describes it, so the table can rebuild it. */
+	static bool MatchesRecord(const FStreamedItem& StreamedItem);
+
+	FItemPlacementTable Table;
+
+	/** Class of each class path in the table, or null if it failed to load. */
+	UPROPERTY(Transient)
+	TArray<UClass*> RecordClasses;
+
+	TMap<FIntPoint, FStreamedCell> LoadedCells;
+
+	/** Loaded cells that still have records to spawn, nearest to a player first. */
+	TArray<FIntPoint> PendingCells;
+
+	/** Records whose item was picked up or destroyed, which are not spawned again. */
+	TBitArray<> ConsumedRecords;
+
+	float TimeSinceCellUpdate{ 0.f };
+};
@@ -0,0 +1,345 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemWorldSubsystem.h"
+
+#include "Item.h"
+#include "Slime.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Items"), STAT_GroundItems, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ground Items Evicted"), STAT_GroundItemsEvicted, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Query Ground Items"), STAT_QueryGroundItems, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Item World Tick"), STAT_ItemWorldTick, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Activate Items"), STAT_ActivateItems, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Item Activations"), STAT_PendingItemActivations, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarGroundItemBudget(
+	TEXT("slime.Items.GroundBudget"),
+	1000,
+	TEXT("Most items allowed on the ground at once. The least recently relevant items are destroyed past this. 0 disables the limit."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarGroundItemRelevanceRadius(
+	TEXT("slime.Items.RelevanceRadius"),
+	3000.f,
+	TEXT("Ground items within this distance of a player pawn are marked as relevant."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarGroundItemRelevanceInterval(
+	TEXT("slime.Items.RelevanceInterval"),
+	0.5f,
+	TEXT("Seconds between ground item relevance updates."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDeferItemActivation(
+	TEXT("slime.Items.DeferActivation"),
+	1,
+	TEXT("1: items loaded with the level are activated over several frames. 0: every item activates in its BeginPlay."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarItemActivationBudgetMs(
+	TEXT("slime.Items.ActivationBudgetMs"),
+	0.5f,
+	TEXT("Game thread time per frame spent activating deferred items. At least one item is activated per frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarItemActivationReorderDistance(
+	TEXT("slime.Items.ActivationReorderDistance"),
+	500.f,
+	TEXT("Distance a player pawn moves before the deferred item activation queue is reordered around it."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld GroundItemStatsCommand(
+	TEXT("slime.Items.Stats"),
+	TEXT("Logs the number of ground items and how many have been evicted by the ground budget."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UItemWorldSubsystem* ItemSubsystem = World ? World->GetSubsystem<UItemWorldSubsystem>() : nullptr)
+		{
+			UE_LOG(LogSlime, Display, TEXT("Ground items: %d / %d, evicted: %d, pending activation: %d"),
+				ItemSubsystem->GetNumGroundItems(),
+				CVarGroundItemBudget.GetValueOnGameThread(),
+				ItemSubsystem->GetNumEvictedItems(),
+				ItemSubsystem->GetNumPendingActivations());
+		}
+	}));
+
+/** How many of the least relevant items are compared by rarity when picking one to evict. */
+static constexpr int32 EvictionCandidates{ 8 };
+
+void UItemWorldSubsystem::RegisterGroundItem(AItem* Item)
+{
+	if (Item == nullptr || GroundItems.Contains(Item)) return;
+
+	const FIntPoint Cell{ GetCell(Item->GetActorLocation()) };
+	Cells.FindOrAdd(Cell).Add(Item);
+
+	// Newly dropped / spawned items start out as the most relevant.
+	RelevanceList.AddHead(Item);
+	GroundItems.Add(Item, FGroundItemEntry{ Cell, RelevanceList.GetHead() });
+	SET_DWORD_STAT(STAT_GroundItems, GroundItems.Num());
+}
+
+void UItemWorldSubsystem::UnregisterGroundItem(AItem* Item)
+{
+	FGroundItemEntry Entry;
+	if (!GroundItems.RemoveAndCopyValue(Item, Entry)) return;
+
+	if (TArray<AItem*>* CellItems = Cells.Find(Entry.Cell))
+	{
+		CellItems->RemoveSingleSwap(Item, false);
+		if (CellItems->Num() == 0)
+		{
+			Cells.Remove(Entry.Cell);
+		}
+	}
+	RelevanceList.RemoveNode(Entry.RelevanceNode);
+	SET_DWORD_STAT(STAT_GroundItems, GroundItems.Num());
+}
+
+void UItemWorldSubsystem::TouchGroundItem(const AItem* Item)
+{
+	FGroundItemEntry* Entry{ GroundItems.Find(Item) };
+	if (Entry == nullptr || Entry->RelevanceNode == RelevanceList.GetHead()) return;
+
+	AItem* ItemToTouch{ Entry->RelevanceNode->GetValue() };
+	RelevanceList.RemoveNode(Entry->RelevanceNode);
+	RelevanceList.AddHead(ItemToTouch);
+	Entry->RelevanceNode = RelevanceList.GetHead();
+}
+
+void UItemWorldSubsystem::GetGroundItems(TArray<AItem*>& OutItems) const
+{
+	OutItems.Reserve(OutItems.Num() + GroundItems.Num() + PendingActivations.Num());
+	for (const TPair<const AItem*, FGroundItemEntry>& Entry : GroundItems)
+	{
+		OutItems.Add(const_cast<AItem*>(Entry.Key));
+	}
+
+	// Queued items haven't registered yet.
+	for (const FPendingActivation& Pending : PendingActivations)
+	{
+		AItem* Item{ Pending.Item.Get() };
+		if (Item && Item->GetItemState() == EItemState::EIS_Pickup)
+		{
+			OutItems.Add(Item);
+		}
+	}
+}
+
+void UItemWorldSubsystem::QueryGroundItems(const FVector& Location, float Radius, TArray<AItem*>& OutItems) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_QueryGroundItems);
+
+	const FIntPoint MinCell{ GetCell(Location - FVector(Radius)) };
+	const FIntPoint MaxCell{ GetCell(Location + FVector(Radius)) };
+	const float RadiusSquared{ FMath::Square(Radius) };
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<AItem*>* CellItems = Cells.Find(FIntPoint(X, Y));
+			if (CellItems == nullptr) continue;
+
+			for (AItem* Item : *CellItems)
+			{
+				if (FVector::DistSquared(Item->GetActorLocation(), Location) <= RadiusSquared)
+				{
+					OutItems.Add(Item);
+				}
+			}
+		}
+	}
+}
+
+void UItemWorldSubsystem::QueueActivation(AItem* Item)
+{
+	if (Item == nullptr || Item->IsActivated()) return;
+
+	if (PendingActivations.Num() == 0 && NumActivatedInBurst == 0)
+	{
+		ActivationStartTime = FPlatformTime::Seconds();
+	}
+	PendingActivations.HeapPush(FPendingActivation{ Item, GetActivationPriority(Item) });
+	SET_DWORD_STAT(STAT_PendingItemActivations, PendingActivations.Num());
+}
+
+bool UItemWorldSubsystem::IsActivationDeferralEnabled()
+{
+	return CVarDeferItemActivation.GetValueOnGameThread() != 0;
+}
+
+void UItemWorldSubsystem::ActivatePendingItems()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActivateItems);
+
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	UpdateActivationOrder();
+
+	RunWithinFrameBudget(StartTime, CVarItemActivationBudgetMs.GetValueOnGameThread(),
+		[this]() { return PendingActivations.Num() > 0; },
+		[this]()
+		{
+			FPendingActivation Pending;
+			PendingActivations.HeapPop(Pending, false);
+			if (AItem* Item = Pending.Item.Get())
+			{
+				Item->ActivateItem();
+				++NumActivatedInBurst;
+			}
+		});
+
+	ActivationWorkSeconds += FPlatformTime::Seconds() - StartTime;
+	++NumActivationFrames;
+	SET_DWORD_STAT(STAT_PendingItemActivations, PendingActivations.Num());
+
+	if (PendingActivations.Num() == 0)
+	{
+		UE_LOG(LogSlime, Log, TEXT("Activated %d items over %d frames: %.2f ms of work, %.2f ms wall time."),
+			NumActivatedInBurst,
+			NumActivationFrames,
+			ActivationWorkSeconds * 1000.0,
+			(FPlatformTime::Seconds() - ActivationStartTime) * 1000.0);
+		PendingActivations.Empty();
+		ActivationOrigins.Reset();
+		NumActivatedInBurst = 0;
+		NumActivationFrames = 0;
+		ActivationWorkSeconds = 0.0;
+	}
+}
+
+float UItemWorldSubsystem::GetActivationPriority(const AItem* Item) const
+{
+	float Nearest{ TNumericLimits<float>::Max() };
+	for (const FVector& Location : ActivationOrigins)
+	{
+		Nearest = FMath::Min(Nearest, FVector::DistSquared(Item->GetActorLocation(), Location));
+	}
+	return Nearest;
+}
+
+void UItemWorldSubsystem::UpdateActivationOrder()
+{
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn{ It->IsValid() ? (*It)->GetPawn() : nullptr };
+		if (Pawn == nullptr) continue;
+
+		PlayerLocations.Add(Pawn->GetActorLocation());
+	}
+
+	// Queued items keep their priority until a player has moved far enough to change what is nearest.
+	bool bMoved{ PlayerLocations.Num() != ActivationOrigins.Num() };
+	const float ReorderDistanceSquared{ FMath::Square(CVarItemActivationReorderDistance.GetValueOnGameThread()) };
+	for (int32 Index = 0; !bMoved && Index < PlayerLocations.Num(); ++Index)
+	{
+		bMoved = FVector::DistSquared(PlayerLocations[Index], ActivationOrigins[Index]) > ReorderDistanceSquared;
+	}
+	if (!bMoved) return;
+
+	ActivationOrigins = PlayerLocations;
+	for (FPendingActivation& Pending : PendingActivations)
+	{
+		const AItem* Item{ Pending.Item.Get() };
+		Pending.Priority = Item ? GetActivationPriority(Item) : 0.f;
+	}
+	PendingActivations.Heapify();
+}
+
+void UItemWorldSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemWorldTick);
+
+	if (PendingActivations.Num() > 0)
+	{
+		ActivatePendingItems();
+	}
+	if (GroundItems.Num() == 0) return;
+
+	TimeSinceRelevanceUpdate += DeltaTime;
+	if (TimeSinceRelevanceUpdate < CVarGroundItemRelevanceInterval.GetValueOnGameThread()) return;
+	TimeSinceRelevanceUpdate = 0.f;
+
+	UpdateRelevance();
+
+	const int32 Budget{ CVarGroundItemBudget.GetValueOnGameThread() };
+	if (Budget > 0)
+	{
+		EnforceBudget(Budget);
+	}
+}
+
+bool UItemWorldSubsystem::IsTickable() const
+{
+	return !IsTemplate() && (GroundItems.Num() > 0 || PendingActivations.Num() > 0);
+}
+
+TStatId UItemWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UItemWorldSubsystem::UpdateRelevance()
+{
+	const float RelevanceRadius{ CVarGroundItemRelevanceRadius.GetValueOnGameThread() };
+	TArray<AItem*> NearbyItems;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn{ It->IsValid() ? (*It)->GetPawn() : nullptr };
+		if (Pawn == nullptr) continue;
+
+		NearbyItems.Reset();
+		QueryGroundItems(Pawn->GetActorLocation(), RelevanceRadius, NearbyItems);
+		for (const AItem* Item : NearbyItems)
+		{
+			TouchGroundItem(Item);
+		}
+	}
+}
+
+void UItemWorldSubsystem::EnforceBudget(int32 Budget)
+{
+	while (GroundItems.Num() > Budget)
+	{
+		// Among the least relevant few, recycle the lowest rarity first, then the oldest.
+		FRelevanceList::TDoubleLinkedListNode* Candidate{ RelevanceList.GetTail() };
+		AItem* ItemToEvict{ Candidate->GetValue() };
+		for (int32 i = 1; i < EvictionCandidates && Candidate->GetPrevNode(); ++i)
+		{
+			Candidate = Candidate->GetPrevNode();
+			if (Candidate->GetValue()->GetItemRarity() < ItemToEvict->GetItemRarity())
+			{
+				ItemToEvict = Candidate->GetValue();
+			}
+		}
+
+		// Unregister first, in case the item survives Destroy() (e.g. it is indestructible).
+		UnregisterGroundItem(ItemToEvict);
+		ItemToEvict->Destroy();
+		++NumEvictedItems;
+		INC_DWORD_STAT(STAT_GroundItemsEvicted);
+	}
+}
+
+void UItemWorldSubsystem::Deinitialize()
+{
+	Cells.Empty();
+	GroundItems.Empty();
+	RelevanceList.Empty();
+	PendingActivations.Empty();
+	ActivationOrigins.Empty();
+
+	Super::Deinitialize();
+}
+
+FIntPoint UItemWorldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize));
+}
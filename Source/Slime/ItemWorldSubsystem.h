@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Containers/List.h"
+#include "ItemWorldSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Keeps every item lying on the ground (EIS_Pickup) in a uniform 2D grid, for cheap proximity queries.
+ * Items register themselves when they enter the Pickup state and unregister when they leave it or end play.
+ *
+ * Ground items are also kept in least-recently-relevant order: items near a player are moved to the front, and
+ * when there are more than slime.Items.GroundBudget items, the least relevant ones are destroyed (lowest rarity first).
+ *
+ * Items placed in the level (or spawned in bulk) queue their activation here instead of activating in BeginPlay().
+ * The queue is drained nearest-to-a-player first, a few items per frame under slime.Items.ActivationBudgetMs.
+ */
+UCLASS()
+class SLIME_API UItemWorldSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterGroundItem(AItem* Item);
+	void UnregisterGroundItem(AItem* Item);
+
+	/** Appends every ground item within Radius of Location to OutItems. */
+	void QueryGroundItems(const FVector& Location, float Radius, TArray<AItem*>& OutItems) const;
+
+	/** Moves the item to the most relevant end of the eviction order. */
+	void TouchGroundItem(const AItem* Item);
+
+	FORCEINLINE int32 GetNumGroundItems() const { return GroundItems.Num(); }
+	FORCEINLINE bool IsGroundItem(const AItem* Item) const { return GroundItems.Contains(Item); }
+	FORCEINLINE int32 GetNumEvictedItems() const { return NumEvictedItems; }
+
+	/** Appends every item lying on the ground to OutItems, including those still waiting to be activated. */
+	void GetGroundItems(TArray<AItem*>& OutItems) const;
+
+	/** Activates the item on a later frame, within the activation budget. */
+	void QueueActivation(AItem* Item);
+	FORCEINLINE int32 GetNumPendingActivations() const { return PendingActivations.Num(); }
+
+	/** Reads slime.Items.DeferActivation. */
+	static bool IsActivationDeferralEnabled();
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+protected:
+	virtual void Deinitialize() override;
+
+private:
+	typedef TDoubleLinkedList<AItem*> FRelevanceList;
+
+	struct FGroundItemEntry
+	{
+		FIntPoint Cell;
+		FRelevanceList::TDoubleLinkedListNode* RelevanceNode;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Touches every ground item near a player pawn. */
+	void UpdateRelevance();
+
+	/** Destroys the least relevant items until the ground budget is met. */
+	void EnforceBudget(int32 Budget);
+
+	/** Activates queued items, nearest to a player first, until this frame's budget is spent. */
+	void ActivatePendingItems();
+
+	/** Squared distance from Item to the nearest of ActivationOrigins, or the largest float if there are none. */
+	float GetActivationPriority(const AItem* Item) const;
+
+	/** Re-keys and re-heapifies the queue once a player pawn appears, leaves, or has moved far enough. */
+	void UpdateActivationOrder();
+
+	/** Edge length of a grid cell. */
+	float CellSize{ 500.f };
+
+	/** Items per occupied cell. Items always unregister before they are destroyed, so raw pointers are safe. */
+	TMap<FIntPoint, TArray<AItem*>> Cells;
+
+	/** Cell and relevance list node of each registered item. */
+	TMap<const AItem*, FGroundItemEntry> GroundItems;
+
+	/** Ground items, most recently relevant at the head. */
+	FRelevanceList RelevanceList;
+
+	struct FPendingActivation
+	{
+		TWeakObjectPtr<AItem> Item;
+
+		/** Squared distance to the nearest player pawn when the queue was last ordered. */
+		float Priority;
+
+		FORCEINLINE bool operator<(const FPendingActivation& Other) const { return Priority < Other.Priority; }
+	};
+
+	/** Min-heap of items waiting to be activated, nearest to a player at the top. */
+	TArray<FPendingActivation> PendingActivations;
+
+	/** Player pawn locations the queue is ordered by. */
+	TArray<FVector, TInlineAllocator<4>> ActivationOrigins;
+
+	/** Totals for the current activation burst, logged when the queue empties. */
+	int32 NumActivatedInBurst{ 0 };
+	int32 NumActivationFrames{ 0 };
+	double ActivationWorkSeconds{ 0.0 };
+	double ActivationStartTime{ 0.0 };
+
+	float TimeSinceRelevanceUpdate{ 0.f };
+	int32 NumEvictedItems{ 0 };
+};
@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LootDirectorSubsystem.h"
+
+#include "LootSpawnZone.h"
+#include "LootTable.h"
+#include "Slime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Loot Director Tick"), STAT_LootDirectorTick, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loot Pending Spawns"), STAT_LootPendingSpawns, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loot Spawned This Frame"), STAT_LootSpawnedThisFrame, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarLootSeed(
+	TEXT("slime.Loot.Seed"),
+	0,
+	TEXT("Seed for loot rolls. The same seed on the same map always produces the same items."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLootSpawnBudgetMs(
+	TEXT("slime.Loot.SpawnBudgetMs"),
+	1.f,
+	TEXT("Game thread time per frame the loot director may spend spawning items. At least one item is spawned per frame."),
+	ECVF_Default);
+
+void ULootDirectorSubsystem::RegisterZone(ALootSpawnZone* Zone)
+{
+	if (Zone == nullptr || Zone->GetNumItems() <= 0) return;
+
+	const FRandomStream Stream{ HashCombine(static_cast<uint32>(CVarLootSeed.GetValueOnGameThread()), static_cast<uint32>(Zone->GetZoneSeed())) };
+
+	// Build the alias tables once per zone, then every roll is O(1).
+	TArray<float, TInlineAllocator<16>> Weights;
+	auto BuildTable = [&Weights](FLootAliasTable& Table, const auto& Entries)
+	{
+		Weights.Reset();
+		for (const auto& Entry : Entries)
+		{
+			Weights.Add(Entry.Weight);
+		}
+		Table.Build(Weights);
+	};
+
+	FLootAliasTable RarityTable;
+	FLootAliasTable WeaponTable;
+	FLootAliasTable AmmoTable;
+	BuildTable(RarityTable, Zone->GetRarityWeights());
+	BuildTable(WeaponTable, Zone->GetWeaponWeights());
+	BuildTable(AmmoTable, Zone->GetAmmoWeights());
+
+	// Weapons can only be rolled if there is something to roll, same for ammo.
+	const float KindWeights[] = {
+		WeaponTable.IsEmpty() ? 0.f : Zone->GetWeaponWeight(),
+		AmmoTable.IsEmpty() ? 0.f : Zone->GetAmmoWeight() };
+	FLootAliasTable KindTable;
+	KindTable.Build(MakeArrayView(KindWeights));
+	if (KindTable.IsEmpty())
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Loot zone %s has no weapon or ammo entries to roll."), *Zone->GetName());
+		return;
+	}
+
+	Pending.Reserve(GetNumPending() + Zone->GetNumItems());
+	for (int32 i = 0; i < Zone->GetNumItems(); ++i)
+	{
+		FLootSpawnRequest Request;
+		Request.bSnapToGround = Zone->ShouldSnapToGround();
+		Request.Transform = FTransform(
+			FRotator(0.f, Stream.FRandRange(0.f, 360.f), 0.f),
+			Zone->RandomPointInZone(Stream));
+
+		if (KindTable.Sample(Stream) == 0)
+		{
+			const FLootWeaponWeight& Entry{ Zone->GetWeaponWeights()[WeaponTable.Sample(Stream)] };
+			Request.ItemClass = Entry.WeaponClass;
+			Request.WeaponType = Entry.WeaponType;
+			const int32 RarityIndex{ RarityTable.Sample(Stream) };
+			if (RarityIndex != INDEX_NONE)
+			{
+				Request.Rarity = Zone->GetRarityWeights()[RarityIndex].Rarity;
+			}
+		}
+		else
+		{
+			const FLootAmmoWeight& Entry{ Zone->GetAmmoWeights()[AmmoTable.Sample(Stream)] };
+			Request.ItemClass = Entry.AmmoClass;
+			Request.AmmoType = Entry.AmmoType;
+			Request.ItemCount = Stream.RandRange(Entry.MinCount, FMath::Max(Entry.MinCount, Entry.MaxCount));
+		}
+		Pending.Add(MoveTemp(Request));
+	}
+	SET_DWORD_STAT(STAT_LootPendingSpawns, GetNumPending());
+}
+
+void ULootDirectorSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LootDirectorTick);
+
+	int32 NumSpawned{ 0 };
+	RunWithinFrameBudget(FPlatformTime::Seconds(), CVarLootSpawnBudgetMs.GetValueOnGameThread(),
+		[this]() { return PendingHead < Pending.Num(); },
+		[this, &NumSpawned]()
+		{
+			SpawnRequest(Pending[PendingHead++]);
+			++NumSpawned;
+		});
+
+	if (PendingHead >= Pending.Num())
+	{
+		UE_LOG(LogSlime, Log, TEXT("Loot director finished spawning %d items."), Pending.Num());
+		Pending.Empty();
+		PendingHead = 0;
+	}
+
+	SET_DWORD_STAT(STAT_LootSpawnedThisFrame, NumSpawned);
+	SET_DWORD_STAT(STAT_LootPendingSpawns, GetNumPending());
+}
+
+bool ULootDirectorSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingHead < Pending.Num();
+}
+
+TStatId ULootDirectorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULootDirectorSubsystem, STATGROUP_Tickables);
+}
+
+void ULootDirectorSubsystem::Deinitialize()
+{
+	Pending.Empty();
+	PendingHead = 0;
+
+	Super::Deinitialize();
+}
+
+AItem* ULootDirectorSubsystem::SpawnRequest(const FLootSpawnRequest& Request)
+{
+	if (!Request.ItemClass) return nullptr;
+
+	FTransform SpawnTransform{ Request.Transform };
+	if (Request.bSnapToGround)
+	{
+		FHitResult GroundHit;
+		const FVector Start{ SpawnTransform.GetLocation() };
+		const FVector End{ Start - FVector(0.f, 0.f, 10'000.f) };
+		if (GetWorld()->LineTraceSingleByChannel(GroundHit, Start, End, ECollisionChannel::ECC_WorldStatic))
+		{
+			SpawnTransform.SetLocation(GroundHit.Location);
+		}
+	}
+
+	FItemSpawnParams Params;
+	Params.Rarity = Request.Rarity;
+	Params.bDeferActivation = true;
+	if (Request.ItemClass->IsChildOf(AWeapon::StaticClass()))
+	{
+		Params.SubType = static_cast<uint8>(Request.WeaponType);
+	}
+	else
+	{
+		Params.SubType = static_cast<uint8>(Request.AmmoType);
+		Params.ItemCount = Request.ItemCount;
+	}
+	return AItem::SpawnItem(GetWorld(), Request.ItemClass, SpawnTransform, Params);
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "AmmoType.h"
+#include "LootDirectorSubsystem.generated.h"
+
+/** One rolled item waiting to be spawned. */
+struct FLootSpawnRequest
+{
+	TSubclassOf<AItem> ItemClass;
+	FTransform Transform;
+	EItemRarity Rarity{ EItemRarity::EIR_Common };
+	EWeaponType WeaponType{ EWeaponType::EWT_MAX };
+	EAmmoType AmmoType{ EAmmoType::EAT_MAX };
+	int32 ItemCount{ 0 };
+	bool bSnapToGround{ false };
+};
+
+/**
+ * Rolls the loot tables of every ALootSpawnZone and spawns the results spread across frames.
+ * Rolls are made up front from a stream seeded by slime.Loot.Seed and the zone's seed, so a given map always
+ * produces the same items. Spawning is limited per frame by slime.Loot.SpawnBudgetMs.
+ */
+UCLASS()
+class SLIME_API ULootDirectorSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Rolls all items for the zone and queues them for spawning. */
+	void RegisterZone(class ALootSpawnZone* Zone);
+
+	/** Number of rolled items not yet spawned. */
+	FORCEINLINE int32 GetNumPending() const { return Pending.Num() - PendingHead; }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+protected:
+	virtual void Deinitialize() override;
+
+private:
+	/** Spawns a single rolled item. Returns the spawned item, or nullptr if the class was not set. */
+	AItem* SpawnRequest(const FLootSpawnRequest& Request);
+
+	/** FIFO of rolled items, consumed from PendingHead. */
+	TArray<FLootSpawnRequest> Pending;
+	int32 PendingHead{ 0 };
+};
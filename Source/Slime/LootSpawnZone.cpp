@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LootSpawnZone.h"
+
+#include "LootDirectorSubsystem.h"
+#include "Components/BoxComponent.h"
+
+ALootSpawnZone::ALootSpawnZone() :
+	NumItems(10),
+	WeaponWeight(1.f),
+	AmmoWeight(3.f),
+	bSnapToGround(true),
+	ZoneSeed(0)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SpawnBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("SpawnBounds"));
+	SetRootComponent(SpawnBounds);
+	SpawnBounds->SetBoxExtent(FVector(500.f, 500.f, 100.f));
+	SpawnBounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SpawnBounds->SetGenerateOverlapEvents(false);
+}
+
+void ALootSpawnZone::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (ULootDirectorSubsystem* LootDirector = GetWorld()->GetSubsystem<ULootDirectorSubsystem>())
+	{
+		LootDirector->RegisterZone(this);
+	}
+}
+
+FVector ALootSpawnZone::RandomPointInZone(const FRandomStream& Stream) const
+{
+	const FVector Extent{ SpawnBounds->GetScaledBoxExtent() };
+	const FVector LocalPoint{
+		Stream.FRandRange(-Extent.X, Extent.X),
+		Stream.FRandRange(-Extent.Y, Extent.Y),
+		Stream.FRandRange(-Extent.Z, Extent.Z) };
+	return SpawnBounds->GetComponentTransform().TransformPositionNoScale(LocalPoint);
+}
+
+int32 ALootSpawnZone::GetZoneSeed() const
+{
+	return ZoneSeed != 0 ? ZoneSeed : static_cast<int32>(GetTypeHash(GetFName().ToString()));
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "LootTable.h"
+#include "LootSpawnZone.generated.h"
+
+/**
+ * Box volume holding the weighted loot tables for one area of the map.
+ * Registers with the ULootDirectorSubsystem on BeginPlay, which rolls and spawns the items over several frames.
+ */
+UCLASS()
+class SLIME_API ALootSpawnZone : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ALootSpawnZone();
+
+	/** Returns a random point inside the zone's box, using the given stream. */
+	FVector RandomPointInZone(const FRandomStream& Stream) const;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	/** Area items are spawned in. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	class UBoxComponent* SpawnBounds;
+
+	/** Number of items rolled for this zone. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 NumItems;
+
+	/** Relative chance of rolling a weapon (vs. ammo). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float WeaponWeight;
+
+	/** Relative chance of rolling ammo (vs. a weapon). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float AmmoWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TArray<FLootRarityWeight> RarityWeights;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TArray<FLootWeaponWeight> WeaponWeights;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TArray<FLootAmmoWeight> AmmoWeights;
+
+	/** Trace down from the rolled point and place the item on the ground. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	bool bSnapToGround;
+
+	/** Mixed into the director's seed, so identical zones still roll differently. 0 uses a hash of the actor name. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	int32 ZoneSeed;
+
+public:
+	FORCEINLINE int32 GetNumItems() const { return NumItems; }
+	FORCEINLINE float GetWeaponWeight() const { return WeaponWeight; }
+	FORCEINLINE float GetAmmoWeight() const { return AmmoWeight; }
+	FORCEINLINE const TArray<FLootRarityWeight>& GetRarityWeights() const { return RarityWeights; }
+	FORCEINLINE const TArray<FLootWeaponWeight>& GetWeaponWeights() const { return WeaponWeights; }
+	FORCEINLINE const TArray<FLootAmmoWeight>& GetAmmoWeights() const { return AmmoWeights; }
+	FORCEINLINE bool ShouldSnapToGround() const { return bSnapToGround; }
+	int32 GetZoneSeed() const;
+};
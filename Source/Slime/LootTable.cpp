@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LootTable.h"
+
+void FLootAliasTable::Build(TArrayView<const float> Weights)
+{
+	Reset();
+
+	const int32 Num{ Weights.Num() };
+	float TotalWeight{ 0.f };
+	for (const float Weight : Weights)
+	{
+		TotalWeight += FMath::Max(Weight, 0.f);
+	}
+	if (Num == 0 || TotalWeight <= 0.f) return;
+
+	Probability.SetNumUninitialized(Num);
+	Alias.SetNumUninitialized(Num);
+
+	// Scale weights so the average column is exactly 1.0, then split into under- and over-full columns.
+	TArray<float, TInlineAllocator<32>> Scaled;
+	TArray<int32, TInlineAllocator<32>> Small;
+	TArray<int32, TInlineAllocator<32>> Large;
+	Scaled.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Scaled[i] = FMath::Max(Weights[i], 0.f) * Num / TotalWeight;
+		Scaled[i] < 1.f ? Small.Add(i) : Large.Add(i);
+	}
+
+	// Top up each under-full column with the remainder of an over-full one.
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const int32 Less{ Small.Pop(false) };
+		const int32 More{ Large.Pop(false) };
+		Probability[Less] = Scaled[Less];
+		Alias[Less] = More;
+		Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.f;
+		Scaled[More] < 1.f ? Small.Add(More) : Large.Add(More);
+	}
+
+	// Whatever remains is full (up to float error).
+	for (const int32 Index : Large)
+	{
+		Probability[Index] = 1.f;
+		Alias[Index] = Index;
+	}
+	for (const int32 Index : Small)
+	{
+		Probability[Index] = 1.f;
+		Alias[Index] = Index;
+	}
+}
+
+int32 FLootAliasTable::Sample(const FRandomStream& Stream) const
+{
+	if (IsEmpty()) return INDEX_NONE;
+
+	const int32 Column{ Stream.RandHelper(Probability.Num()) };
+	return Stream.GetFraction() < Probability[Column] ? Column : Alias[Column];
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "AmmoType.h"
+#include "LootTable.generated.h"
+
+/** Weight for rolling an item rarity. */
+USTRUCT(BlueprintType)
+struct FLootRarityWeight
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EItemRarity Rarity = EItemRarity::EIR_Common;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0"))
+	float Weight = 1.f;
+};
+
+/** Weight for rolling a weapon, and the class spawned for it. */
+USTRUCT(BlueprintType)
+struct FLootWeaponWeight
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EWeaponType WeaponType = EWeaponType::EWT_SubmachineGun;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<AWeapon> WeaponClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0"))
+	float Weight = 1.f;
+};
+
+/** Weight for rolling an ammo pickup, its class and count range. */
+USTRUCT(BlueprintType)
+struct FLootAmmoWeight
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EAmmoType AmmoType = EAmmoType::EAT_9mm;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<class AAmmo> AmmoClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0"))
+	float Weight = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 MinCount = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 MaxCount = 30;
+};
+
+/**
+ * Walker / Vose alias table: O(n) to build, O(1) to sample a weighted index.
+ * Negative weights count as zero.  Sampling an empty table returns INDEX_NONE.
+ */
+struct SLIME_API FLootAliasTable
+{
+	void Build(TArrayView<const float> Weights);
+	int32 Sample(const FRandomStream& Stream) const;
+
+	FORCEINLINE bool IsEmpty() const { return Probability.Num() == 0; }
+	FORCEINLINE void Reset() { Probability.Reset(); Alias.Reset(); }
+
+private:
+	TArray<float> Probability;
+	TArray<int32> Alias;
+};
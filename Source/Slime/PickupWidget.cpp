@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupWidget.h"
+
+void UPickupWidget::SetItem(const AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	ItemName = Item->GetItemName();
+	ItemCount = Item->GetItemCount();
+	ItemType = Item->GetItemType();
+	ItemRarity = Item->GetItemRarity();
+	NumberOfStars = Item->GetNumberOfStars();
+	IconBackground = Item->GetIconBackground();
+	IconImage = Item->GetIconImage();
+	AmmoIcon = Item->GetAmmoIcon();
+	bWidgetTextIsSwap = Item->GetWidgetTextIsSwap();
+
+	OnItemChanged();
+}
+
+bool UPickupWidget::IsUpToDate(const AItem* Item) const
+{
+	return Item->GetItemCount() == ItemCount && Item->GetWidgetTextIsSwap() == bWidgetTextIsSwap;
+}
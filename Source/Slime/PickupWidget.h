@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Item.h"
+#include "PickupWidget.generated.h"
+
+/**
+ * Pickup prompt shared by all items. One instance per local player is moved to the traced item and filled from it,
+ * instead of every item owning its own widget component.
+ */
+UCLASS()
+class SLIME_API UPickupWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Copies the display data from the item and notifies the Blueprint. */
+	void SetItem(const AItem* Item);
+
+	/** False once the item's count or prompt differs from what the widget was last filled with. */
+	bool IsUpToDate(const AItem* Item) const;
+
+protected:
+	/** Called after the item data has changed, to refresh the widget's visuals. */
+	UFUNCTION(BlueprintImplementableEvent, Category = Pickup)
+	void OnItemChanged();
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	FString ItemName;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	int32 ItemCount;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	EItemType ItemType;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	EItemRarity ItemRarity;
+
+	/** Number of rarity stars to show. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	int32 NumberOfStars;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* IconBackground;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* IconImage;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	UTexture2D* AmmoIcon;
+
+	/** Shows "Swap" instead of "Pick up" when the inventory is full. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	bool bWidgetTextIsSwap;
+};
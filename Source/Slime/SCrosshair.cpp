@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SCrosshair.h"
+
+#include "Slime.h"
+#include "Rendering/DrawElements.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Repaints"), STAT_CrosshairRepaints, STATGROUP_Slime);
+
+SCrosshair::SCrosshair() :
+	TopImage(nullptr),
+	BottomImage(nullptr),
+	LeftImage(nullptr),
+	RightImage(nullptr),
+	BaseOffset(0.f),
+	SpreadScale(16.f),
+	RepaintThreshold(0.5f),
+	PaintedSpread(0.f)
+{
+	SetCanTick(false);
+}
+
+void SCrosshair::Construct(const FArguments& InArgs)
+{
+	SetImages(InArgs._TopImage, InArgs._BottomImage, InArgs._LeftImage, InArgs._RightImage);
+	SetLayout(InArgs._BaseOffset, InArgs._SpreadScale, InArgs._RepaintThreshold);
+	SetSpread(InArgs._Spread);
+
+	RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SCrosshair::UpdateSpread));
+}
+
+void SCrosshair::SetImages(const FSlateBrush* InTopImage, const FSlateBrush* InBottomImage, const FSlateBrush* InLeftImage, const FSlateBrush* InRightImage)
+{
+	TopImage = InTopImage;
+	BottomImage = InBottomImage;
+	LeftImage = InLeftImage;
+	RightImage = InRightImage;
+	Invalidate(EInvalidateWidgetReason::Layout);
+}
+
+void SCrosshair::SetSpread(const TAttribute<float>& InSpread)
+{
+	Spread = InSpread;
+}
+
+void SCrosshair::SetLayout(float InBaseOffset, float InSpreadScale, float InRepaintThreshold)
+{
+	BaseOffset = InBaseOffset;
+	SpreadScale = InSpreadScale;
+	RepaintThreshold = FMath::Max(InRepaintThreshold, 0.f);
+	Invalidate(EInvalidateWidgetReason::Layout);
+}
+
+EActiveTimerReturnType SCrosshair::UpdateSpread(double InCurrentTime, float InDeltaTime)
+{
+	const float NewSpread{ Spread.Get(0.f) };
+	if (FMath::Abs(NewSpread - PaintedSpread) * SpreadScale > RepaintThreshold)
+	{
+		PaintedSpread = NewSpread;
+		INC_DWORD_STAT(STAT_CrosshairRepaints);
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+	return EActiveTimerReturnType::Continue;
+}
+
+int32 SCrosshair::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const FVector2D Center{ AllottedGeometry.GetLocalSize() * 0.5f };
+	const float Offset{ BaseOffset + PaintedSpread * SpreadScale };
+	const ESlateDrawEffect DrawEffects{ ShouldBeEnabled(bParentEnabled) ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect };
+
+	auto PaintImage = [&](const FSlateBrush* Image, const FVector2D& Direction)
+	{
+		if (Image == nullptr || Image->DrawAs == ESlateBrushDrawType::NoDrawType) return;
+
+		// Center the image on its axis, with its inner edge Offset pixels from the middle.
+		const FVector2D Size{ Image->ImageSize };
+		const FVector2D Position{ Center + Direction * (Offset + Size * 0.5f) - Size * 0.5f };
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Position, Size),
+			Image,
+			DrawEffects,
+			Image->GetTint(InWidgetStyle) * InWidgetStyle.GetColorAndOpacityTint());
+	};
+
+	PaintImage(TopImage, FVector2D(0.f, -1.f));
+	PaintImage(BottomImage, FVector2D(0.f, 1.f));
+	PaintImage(LeftImage, FVector2D(-1.f, 0.f));
+	PaintImage(RightImage, FVector2D(1.f, 0.f));
+
+	return LayerId;
+}
+
+FVector2D SCrosshair::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	// Sized for zero spread. Spread draws outside the bounds instead of changing the layout every frame.
+	auto ImageSize = [](const FSlateBrush* Image) { return Image ? Image->ImageSize : FVector2D::ZeroVector; };
+	const float Width{ ImageSize(LeftImage).X + ImageSize(RightImage).X + BaseOffset * 2.f };
+	const float Height{ ImageSize(TopImage).Y + ImageSize(BottomImage).Y + BaseOffset * 2.f };
+	return FVector2D(
+		FMath::Max3(Width, ImageSize(TopImage).X, ImageSize(BottomImage).X),
+		FMath::Max3(Height, ImageSize(LeftImage).Y, ImageSize(RightImage).Y));
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+/**
+ * Four crosshair images pushed apart by a spread value. The spread is read natively once per frame, and the widget
+ * only invalidates its paint when the images would move by more than RepaintThreshold pixels.
+ */
+class SLIME_API SCrosshair : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SCrosshair)
+		: _TopImage(nullptr)
+		, _BottomImage(nullptr)
+		, _LeftImage(nullptr)
+		, _RightImage(nullptr)
+		, _Spread(0.f)
+		, _BaseOffset(0.f)
+		, _SpreadScale(16.f)
+		, _RepaintThreshold(0.5f)
+	{}
+		SLATE_ARGUMENT(const FSlateBrush*, TopImage)
+		SLATE_ARGUMENT(const FSlateBrush*, BottomImage)
+		SLATE_ARGUMENT(const FSlateBrush*, LeftImage)
+		SLATE_ARGUMENT(const FSlateBrush*, RightImage)
+		/** Polled once per frame, not per paint. */
+		SLATE_ATTRIBUTE(float, Spread)
+		/** Distance of each image from the center at zero spread, in pixels. */
+		SLATE_ARGUMENT(float, BaseOffset)
+		/** Pixels each image moves out per unit of spread. */
+		SLATE_ARGUMENT(float, SpreadScale)
+		/** Smallest movement, in pixels, worth a repaint. */
+		SLATE_ARGUMENT(float, RepaintThreshold)
+	SLATE_END_ARGS()
+
+	SCrosshair();
+
+	void Construct(const FArguments& InArgs);
+
+	void SetImages(const FSlateBrush* InTopImage, const FSlateBrush* InBottomImage, const FSlateBrush* InLeftImage, const FSlateBrush* InRightImage);
+	void SetSpread(const TAttribute<float>& InSpread);
+	void SetLayout(float InBaseOffset, float InSpreadScale, float InRepaintThreshold);
+
+	// SWidget
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	/** Reads the spread and repaints if the images moved far enough. */
+	EActiveTimerReturnType UpdateSpread(double InCurrentTime, float InDeltaTime);
+
+	const FSlateBrush* TopImage;
+	const FSlateBrush* BottomImage;
+	const FSlateBrush* LeftImage;
+	const FSlateBrush* RightImage;
+
+	TAttribute<float> Spread;
+	float BaseOffset;
+	float SpreadScale;
+	float RepaintThreshold;
+
+	/** Spread the last paint used. */
+	float PaintedSpread;
+};
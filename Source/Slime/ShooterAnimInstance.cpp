@@ -5,111 +5,150 @@
 #include "ShooterCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Slime.h"
 
-UShooterAnimInstance::UShooterAnimInstance() :
-	Speed(0.f),
-	bIsInAir(false),
-	bIsAccelerating(false),
-	MovementOffsetYaw(0.f),
-	LastMovementOffsetYaw(0.f),
-	bAiming(false),
-	TIPCharacterYaw(0.f),
-	TIPCharacterYawLastFrame(0.f),
-	RootYawOffset(0.f),
-	RotationCurve(0.f),
-	RotationCurveLastFrame(0.f),
-	Pitch(0.f),
-	bReloading(false),
-	OffsetState(EOffsetState::EOS_Hip),
-	CharacterRotation(FRotator(0.f)),
-	CharacterRotationLastFrame(FRotator(0.f)),
-	YawDelta(0.f),
-	bCrouching(false),
-	RecoilWeight(1.f),
-	bTurningInPlace(false)
+DECLARE_CYCLE_STAT(TEXT("Anim Snapshot"), STAT_AnimSnapshot, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Anim Compute"), STAT_AnimCompute, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarAnimThreadedUpdate(
+	TEXT("slime.Anim.ThreadedUpdate"),
+	1,
+	TEXT("1: shooter anim instances compute their properties on animation worker threads. 0: on the game thread, in UpdateAnimationProperties()."),
+	ECVF_Default);
 
+namespace
 {
-	
+	/** Curves of the turn-in-place animations, named once instead of every frame. */
+	const FName TurningCurveName{ TEXT("Turning") };
+	const FName RotationCurveName{ TEXT("Rotation") };
+
+	/**
+	 * Longest gap between updates still treated as continuous. Budgeted meshes update every few frames with the summed
+	 * delta time, which TurnInPlace() and Lean() handle; past this the mesh was off screen or dormant, and the turn since
+	 * its last update isn't one to animate.
+	 */
+	constexpr float MaxContinuousDeltaTime{ 0.5f };
 }
 
-void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
+FShooterAnimInstanceProxy::FShooterAnimInstanceProxy(UShooterAnimInstance* InAnimInstance) :
+	FAnimInstanceProxy(InAnimInstance),
+	ShooterAnimInstance(InAnimInstance)
 {
-	if (ShooterCharacter == nullptr)
+}
+
+void FShooterAnimInstanceProxy::TakeSnapshot(const AShooterCharacter* Character)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AnimSnapshot);
+
+	const UCharacterMovementComponent* Movement{ Character->GetCharacterMovement() };
+	Snapshot.Velocity = Character->GetVelocity();
+	Snapshot.AimRotation = Character->GetBaseAimRotation();
+	Snapshot.ActorRotation = Character->GetActorRotation();
+	Snapshot.bIsInAir = Movement->IsFalling();
+	Snapshot.bIsAccelerating = Movement->GetCurrentAcceleration().SizeSquared() > 0.f;
+	Snapshot.bAiming = Character->GetAiming();
+	Snapshot.bCrouching = Character->GetCrouching();
+	Snapshot.bReloading = Character->GetCombatState() == ECombatState::ECS_Reloading;
+	Snapshot.bEquipping = Character->GetCombatState() == ECombatState::ECS_Equipping;
+}
+
+void FShooterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	bThreadedUpdate = false;
+	if (!UShooterAnimInstance::IsThreadedUpdateEnabled()) return;
+
+	UShooterAnimInstance* AnimInstance{ CastChecked<UShooterAnimInstance>(InAnimInstance) };
+	if (AnimInstance->ShooterCharacter == nullptr)
 	{
-		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+		AnimInstance->ShooterCharacter = Cast<AShooterCharacter>(AnimInstance->TryGetPawnOwner());
 	}
-	if (ShooterCharacter)
+	if (AnimInstance->ShooterCharacter)
 	{
-		bCrouching = ShooterCharacter->GetCrouching();
-		bReloading = (ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading);
-		bEquipping = (ShooterCharacter->GetCombatState() == ECombatState::ECS_Equipping);
-		
-		// Get the lateral speed of the character from velocity.
-		FVector Velocity{ ShooterCharacter->GetVelocity() };
-		Velocity.Z = 0;
-		Speed = Velocity.Size();
-
-		// Is the character in the air?
-		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
-
-		// Is the character accelerating?  
-		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
-		{
-			bIsAccelerating = true;
-		}
-		else
-		{
-			bIsAccelerating = false;
-		}
-		FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX( ShooterCharacter->GetVelocity() );
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+		TakeSnapshot(AnimInstance->ShooterCharacter);
+		bThreadedUpdate = true;
+	}
+}
 
-		if (ShooterCharacter->GetVelocity().Size() > 0.f)
-		{
-			LastMovementOffsetYaw = MovementOffsetYaw;
-		}
+void FShooterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
 
-		bAiming = ShooterCharacter->GetAiming();
+	if (bThreadedUpdate)
+	{
+		Compute(DeltaSeconds);
+	}
+}
 
-		if (bReloading)
-		{
-			OffsetState = EOffsetState::EOS_Reloading;
-		}
-		else if (bIsInAir)
-		{
-			OffsetState = EOffsetState::EOS_InAir;
-		}
-		else if (bAiming)
-		{
-			OffsetState = EOffsetState::EOS_Aiming;
-		}
-		else
-		{
-			OffsetState = EOffsetState::EOS_Hip;
-		}
+void FShooterAnimInstanceProxy::Compute(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AnimCompute);
+
+	UShooterAnimInstance& Anim{ *ShooterAnimInstance };
+	Anim.bCrouching = Snapshot.bCrouching;
+	Anim.bReloading = Snapshot.bReloading;
+	Anim.bEquipping = Snapshot.bEquipping;
+
+	// Get the lateral speed of the character from velocity.
+	FVector Velocity{ Snapshot.Velocity };
+	Velocity.Z = 0;
+	Anim.Speed = Velocity.Size();
+
+	Anim.bIsInAir = Snapshot.bIsInAir;
+	Anim.bIsAccelerating = Snapshot.bIsAccelerating;
+
+	const FRotator MovementRotation{ UKismetMathLibrary::MakeRotFromX(Snapshot.Velocity) };
+	Anim.MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.AimRotation).Yaw;
+
+	if (Snapshot.Velocity.SizeSquared() > 0.f)
+	{
+		Anim.LastMovementOffsetYaw = Anim.MovementOffsetYaw;
+	}
+
+	Anim.bAiming = Snapshot.bAiming;
+
+	if (Anim.bReloading)
+	{
+		Anim.OffsetState = EOffsetState::EOS_Reloading;
+	}
+	else if (Anim.bIsInAir)
+	{
+		Anim.OffsetState = EOffsetState::EOS_InAir;
 	}
+	else if (Anim.bAiming)
+	{
+		Anim.OffsetState = EOffsetState::EOS_Aiming;
+	}
+	else
+	{
+		Anim.OffsetState = EOffsetState::EOS_Hip;
+	}
+
+	if (DeltaTime > MaxContinuousDeltaTime)
+	{
+		// Restart turn in place and lean from the current rotation.
+		TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
+		CharacterRotation = Snapshot.ActorRotation;
+		Anim.RootYawOffset = 0.f;
+		Anim.YawDelta = 0.f;
+	}
+
 	TurnInPlace();
 	SetRecoilWeight();
 	Lean(DeltaTime);
 }
 
-void UShooterAnimInstance::NativeInitializeAnimation()
-{
-	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
-}
-
-void UShooterAnimInstance::TurnInPlace()
+void FShooterAnimInstanceProxy::TurnInPlace()
 {
-	if (ShooterCharacter == nullptr) { return; }
+	UShooterAnimInstance& Anim{ *ShooterAnimInstance };
+	Anim.Pitch = Snapshot.AimRotation.Pitch;
 
-	Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
-
-	if (Speed > 0 || bIsInAir)
+	if (Anim.Speed > 0 || Anim.bIsInAir)
 	{
 		// Don't turn in place, character aligns to movement.
-		RootYawOffset = 0.f;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		Anim.RootYawOffset = 0.f;
+		TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
@@ -117,82 +156,142 @@ void UShooterAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = Snapshot.ActorRotation.Yaw;
 		const float TIPYawDelta { TIPCharacterYaw - TIPCharacterYawLastFrame };
 
 		// Root Yaw Offset, updated and clamped to [-180, 180]
-		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
+		Anim.RootYawOffset = UKismetMathLibrary::NormalizeAxis(Anim.RootYawOffset - TIPYawDelta);
 
-		// 1.0 if turning, 0.0 if not.
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
+		// 1.0 if turning, 0.0 if not. Curves are those of the last evaluation, held by this proxy.
+		const TMap<FName, float>& Curves{ GetAnimationCurves(EAnimCurveType::AttributeCurve) };
+		const float Turning{ Curves.FindRef(TurningCurveName) };
 		if (Turning > 0)
 		{
-			bTurningInPlace = true;
+			Anim.bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = Curves.FindRef(RotationCurveName);
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 
 			// RootYawOffset > 0 means turning left, else turning right
-			RootYawOffset > 0 ? RootYawOffset -= DeltaRotation : RootYawOffset += DeltaRotation;
+			Anim.RootYawOffset > 0 ? Anim.RootYawOffset -= DeltaRotation : Anim.RootYawOffset += DeltaRotation;
 
-			const float ABSRootYawOffset{ FMath::Abs(RootYawOffset) };
+			const float ABSRootYawOffset{ FMath::Abs(Anim.RootYawOffset) };
 			if (ABSRootYawOffset > 90.f)
 			{
 				const float YawExcess{ ABSRootYawOffset - 90.f };
-				RootYawOffset > 0 ? RootYawOffset -= YawExcess : RootYawOffset += YawExcess;				
+				Anim.RootYawOffset > 0 ? Anim.RootYawOffset -= YawExcess : Anim.RootYawOffset += YawExcess;
 			}
 		}
 		else
 		{
-			bTurningInPlace = false;
+			Anim.bTurningInPlace = false;
 		}
 	}
 }
 
-void UShooterAnimInstance::SetRecoilWeight()
+void FShooterAnimInstanceProxy::SetRecoilWeight()
 {
+	UShooterAnimInstance& Anim{ *ShooterAnimInstance };
+
 	// Set recoil weight.
-	if (bTurningInPlace)
+	if (Anim.bTurningInPlace)
 	{
-		if (bReloading || bEquipping)
+		if (Anim.bReloading || Anim.bEquipping)
 		{
-			RecoilWeight = 1.f;  // Recoil does effect reload animation.
+			Anim.RecoilWeight = 1.f;  // Recoil does effect reload animation.
 		}
 		else
 		{
-			RecoilWeight = 0.f;  // Turn-in-place doesn't mix well with recoil.
+			Anim.RecoilWeight = 0.f;  // Turn-in-place doesn't mix well with recoil.
 		}
 	}
 	else // Not turning in place
 	{
-		if (bCrouching)
+		if (Anim.bCrouching)
 		{
-			if (bReloading || bEquipping)
+			if (Anim.bReloading || Anim.bEquipping)
 			{
-				RecoilWeight = 1.f;
+				Anim.RecoilWeight = 1.f;
 			}
 			else
 			{
-				RecoilWeight = 0.025f;  // Low recoil while crouching.
+				Anim.RecoilWeight = 0.025f;  // Low recoil while crouching.
 			}
 		}
 		else  // Not crouching
 		{
-			RecoilWeight = 1.f;  // Normal recoil for firing and reloading.
+			Anim.RecoilWeight = 1.f;  // Normal recoil for firing and reloading.
 		}
 	}
 }
 
-void UShooterAnimInstance::Lean(float DeltaTime)
+void FShooterAnimInstanceProxy::Lean(float DeltaTime)
 {
-	if (ShooterCharacter == nullptr) return;
-	
+	if (DeltaTime <= 0.f) return;
+
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ShooterCharacter->GetActorRotation();
+	CharacterRotation = Snapshot.ActorRotation;
 
 	const FRotator Delta{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
-	
+
+	// Yaw rate over however long this update covers, so the lean is the same at any update rate.
+	UShooterAnimInstance& Anim{ *ShooterAnimInstance };
 	const float Target{ Delta.Yaw / DeltaTime };
-	const float Interp{ FMath::FInterpTo(YawDelta, Target, DeltaTime, 6.f) };
-	YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
+	const float Interp{ FMath::FInterpTo(Anim.YawDelta, Target, DeltaTime, 6.f) };
+	Anim.YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
+}
+
+UShooterAnimInstance::UShooterAnimInstance() :
+	Speed(0.f),
+	bIsInAir(false),
+	bIsAccelerating(false),
+	MovementOffsetYaw(0.f),
+	LastMovementOffsetYaw(0.f),
+	bAiming(false),
+	RootYawOffset(0.f),
+	Pitch(0.f),
+	bReloading(false),
+	OffsetState(EOffsetState::EOS_Hip),
+	YawDelta(0.f),
+	bCrouching(false),
+	RecoilWeight(1.f),
+	bTurningInPlace(false)
+
+{
+
+}
+
+bool UShooterAnimInstance::IsThreadedUpdateEnabled()
+{
+	return CVarAnimThreadedUpdate.GetValueOnGameThread() != 0;
+}
+
+void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
+{
+	if (IsThreadedUpdateEnabled()) return;
+
+	if (ShooterCharacter == nullptr)
+	{
+		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+	}
+	if (ShooterCharacter == nullptr) return;
+
+	FShooterAnimInstanceProxy& Proxy{ GetProxyOnGameThread<FShooterAnimInstanceProxy>() };
+	Proxy.TakeSnapshot(ShooterCharacter);
+	Proxy.Compute(DeltaTime);
+}
+
+void UShooterAnimInstance::NativeInitializeAnimation()
+{
+	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+}
+
+FAnimInstanceProxy* UShooterAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FShooterAnimInstanceProxy(this);
+}
+
+void UShooterAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete InProxy;
 }
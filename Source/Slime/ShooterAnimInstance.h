@@ -4,8 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "ShooterAnimInstance.generated.h"
 
+class AShooterCharacter;
+class UShooterAnimInstance;
+
 
 UENUM(BlueprintType)
 enum class EOffsetState : uint8
@@ -19,27 +23,98 @@ enum class EOffsetState : uint8
 	EOS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/** What the animation update reads from the character, copied on the game thread. */
+struct FShooterAnimSnapshot
+{
+	FVector Velocity{ FVector::ZeroVector };
+	FRotator AimRotation{ FRotator::ZeroRotator };
+	FRotator ActorRotation{ FRotator::ZeroRotator };
+	bool bIsInAir{ false };
+	bool bIsAccelerating{ false };
+	bool bAiming{ false };
+	bool bCrouching{ false };
+	bool bReloading{ false };
+	bool bEquipping{ false };
+};
+
+/**
+ * Runs UShooterAnimInstance's update on an animation worker thread. PreUpdate() copies the character's state into a
+ * snapshot on the game thread; Update() then computes the instance's properties from the snapshot alone, before the
+ * anim graph reads them. Toggled by slime.Anim.ThreadedUpdate.
+ */
+USTRUCT()
+struct SLIME_API FShooterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FShooterAnimInstanceProxy() = default;
+	explicit FShooterAnimInstanceProxy(UShooterAnimInstance* InAnimInstance);
+
+	/** Copies what Compute() reads from Character. Game thread only. */
+	void TakeSnapshot(const AShooterCharacter* Character);
+
+	/** Updates the anim instance's properties from the last snapshot. Safe on any thread. */
+	void Compute(float DeltaTime);
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	void TurnInPlace();
+	void SetRecoilWeight();
+
+	/** Handle calculations for leaning while running. */
+	void Lean(float DeltaTime);
+
+	UShooterAnimInstance* ShooterAnimInstance{ nullptr };
+
+	FShooterAnimSnapshot Snapshot;
+
+	/** True when the snapshot of this frame is to be computed by Update(), rather than by UpdateAnimationProperties(). */
+	bool bThreadedUpdate{ false };
+
+	/** Variables to support Turn in Place (TIP), only updated when standing still and not in air. */
+	float TIPCharacterYaw{ 0.f };
+	float TIPCharacterYawLastFrame{ 0.f };
+
+	/** Rotation Curve value this frame. */
+	float RotationCurve{ 0.f };
+
+	/** Rotation Curve value last frame. */
+	float RotationCurveLastFrame{ 0.f };
+
+	/** Lean Variables to lean while running and turning. */
+	FRotator CharacterRotation{ FRotator::ZeroRotator };
+	FRotator CharacterRotationLastFrame{ FRotator::ZeroRotator };
+};
+
 UCLASS()
 class SLIME_API UShooterAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
 public:
+	/**
+	 * Game thread update, for slime.Anim.ThreadedUpdate 0. Does nothing otherwise: FShooterAnimInstanceProxy does
+	 * the same work on a worker thread, and the AnimBP doesn't need to call this any more.
+	 */
 	UFUNCTION(BlueprintCallable)
 	void UpdateAnimationProperties(float DeltaTime);
 	
 	UShooterAnimInstance();
 
 	virtual void NativeInitializeAnimation() override;
-	void SetRecoilWeight();
 
+	/** Reads slime.Anim.ThreadedUpdate. */
+	static bool IsThreadedUpdateEnabled();
 
 protected:
-	void TurnInPlace();
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
 
-	/** Handle calculations for leaning while running. */
-	void Lean(float DeltaTime);
-	
 private:
+	friend struct FShooterAnimInstanceProxy;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class AShooterCharacter* ShooterCharacter;
 
@@ -67,19 +142,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"));
 	bool bAiming;
 
-	/** Variables to support Turn in Place (TIP), only updated when standing still and not in air. */
-	float TIPCharacterYaw;
-	float TIPCharacterYawLastFrame;
-	
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn in Place", meta = (AllowPrivateAccess = "true"))
 	float RootYawOffset;
 
-	/** Rotation Curve value this frame. */
-	float RotationCurve;
-
-	/** Rotation Curve value last frame. */
-	float RotationCurveLastFrame;
-
 	/** Pitch of the aim rotation used for Aim Offset. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Turn in Place", meta = (AllowPrivateAccess = "true"))
 	float Pitch;
@@ -91,9 +156,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Aim Offset State", meta = (AllowPrivateAccess = "true"))
 	EOffsetState OffsetState;
 
-	/** Lean Variables to lean while running and turning. */
-	FRotator CharacterRotation;
-	FRotator CharacterRotationLastFrame;
+	/** Lean while running and turning. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Lean", meta = (AllowPrivateAccess = "true"))
 	float YawDelta;
 
@@ -2,6 +2,9 @@
 
 
 #include "ShooterCharacter.h"
+#include "ShooterCharacterMovementComponent.h"
+#include "CharacterCosmeticsSubsystem.h"
+#include "ShooterSignificanceSubsystem.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -12,75 +15,76 @@
 #include "Item.h"
 #include "Weapon.h"
 #include "Components/WidgetComponent.h"
+#include "PickupWidget.h"
 #include "Components/CapsuleComponent.h"
 #include "Ammo.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "Slime.h"
 #include "Components/AudioComponent.h"
+#include "ItemWorldSubsystem.h"
+#include "ShooterHUDModel.h"
+#include "ShooterSaveGame.h"
+#include "ShooterWaterVolume.h"
+#include "FootstepBank.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+DECLARE_CYCLE_STAT(TEXT("Find Target Item"), STAT_FindTargetItem, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Character Interpolators"), STAT_CharacterInterpolators, STATGROUP_Slime);
+
+namespace
+{
+	/** Distance from its target at which an interpolator snaps to it and sleeps: degrees of FOV, spread, or capsule units. */
+	constexpr float InterpolatorTolerance{ 0.01f };
+
+#if WITH_EDITORONLY_DATA
+	/** Calls Function with each deprecated tuning property of AShooterCharacter and the UShooterCharacterConfig one it moved to. */
+	void ForEachMovedTuning(TFunctionRef<void(const FProperty& Deprecated, const FProperty& Moved)> Function)
+	{
+		for (TFieldIterator<FProperty> It(AShooterCharacter::StaticClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_Deprecated)) continue;
+
+			FString Name{ It->GetName() };
+			Name.RemoveFromEnd(TEXT("_DEPRECATED"));
+			const FProperty* Moved{ FindFProperty<FProperty>(UShooterCharacterConfig::StaticClass(), *Name) };
+			if (Moved && Moved->SameType(*It))
+			{
+				Function(**It, *Moved);
+			}
+		}
+	}
+#endif
+}
 
 // Set default values.
-AShooterCharacter::AShooterCharacter() :
-	// Base for turning / looking up.
-	BaseTurnRate(45.f),
-	BaseLookUpRate(45.f),
-	// Turn rate while aiming / not aiming - for console controller.
-	HipTurnRate(90.f),
-	HipLookUpRate(90.f),
-	AimingTurnRate(40.f),
-	AimingLookUpRate(40.f),
-	// Turn rate while aiming / not aiming - for mouse controller.
-	MouseHipTurnRate(1.0f),
-	MouseHipLookUpRate(1.0f),
-	MouseAimingTurnRate(0.66f),
-	MouseAimingLookUpRate(0.66f),
-	// True when aiming.
-	bAiming(false),
-	// Camera Field of View.
-	CameraDefaultFOV(0.f), // Set in BeginPlay().
-	CameraZoomedFOV(28.f),
-	CameraCurrentFOV(0.f),  // Set in BeginPlay().
-	ZoomInterpSpeed(20.f),
-	// Crosshair spread, updated via Tick() in SetCrosshairSpreadMultiplier().
-	CrosshairSpreadMultiplier(0.5),
-	CrosshairVelocityFactor(0.f),
-	CrosshairInAirFactor(0.f),
-	CrosshairAimFactor(0.f),
-	CrosshairShootingFactor(0.f),
-	// Used for bullet fire timer. 
-	ShootTimeDuration(0.12f),
-	bFiringBullet(false),
-	// Used for automatic weapon fire.
-	AutomaticFireRate(0.1f),
-	bShouldFire(true),
-	bFireButtonPressed(false),
-	// Item trace
-	bShouldTraceForItems(false),
-	// For interpolating items being equipped momentarily to the front of player's view
-	CameraInterpDistance(250.f),
-	CameraInterpElevation(65.f),
-	// Ammo
-	Starting9mmAmmo(108),
-	StartingARAmmo(40),
-	// Combat state
-	CombatState(ECombatState::ECS_Unoccupied),
+AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer
+		.SetDefaultSubobjectClass<UShooterCharacterMovementComponent>(ACharacter::CharacterMovementComponentName)
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)),
+	// Hot per-frame state and shared tuning, see FShooterCharacterHotState and UShooterCharacterConfig.
+	Hot(),
+	Config(nullptr),
 	// Movement and aiming
-	bCrouching(false),
-	BaseMovementSpeed(650.f),
-	CrouchMovementSpeed(300.f),
-	AimMovementSpeed(450.f),
-	StandingCapsuleHalfHeight(88.f),
-	CrouchingCapsuleHalfHeight(44.f),
-	bAimingButtonPressed(false),
+	CameraBoomBaseLocation(FVector::ZeroVector),
 	// Underwater
 	bUnderwater(false),
-	SetUnderwaterTimerRate(0.2),
+	FootstepBank(nullptr),
+	FootstepFloorFaceIndex(INDEX_NONE),
+	FootstepSurface(EPS_DEFAULT),
+	WaterVolume(nullptr),
 	// Inventory
+	OccupiedInventorySlots(0),
+	HUDModel(nullptr),
 	HighlightedSlot(-1)
 
 {
 	// Set this character to call Tick() every frame.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// The mesh registers with the animation budget allocator; UShooterSignificanceSubsystem supplies its significance.
+	USkeletalMeshComponentBudgeted* BudgetedMesh{ CastChecked<USkeletalMeshComponentBudgeted>(GetMesh()) };
+	BudgetedMesh->SetAutoCalculateSignificance(false);
+
 	// Create a camera boom (which pulls in towards the character if there is a collision).
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -106,6 +110,23 @@ AShooterCharacter::AShooterCharacter() :
 
 	// Create hand scene component, attached in GrabClip().
 	HandSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("HandSceneComponent"));
+
+	// Only plays under water, so it starts inactive.
+	UnderwaterSoundPlayer = CreateDefaultSubobject<UAudioComponent>(TEXT("UnderwaterSoundPlayer"));
+	UnderwaterSoundPlayer->SetupAttachment(GetMesh());
+	UnderwaterSoundPlayer->bAutoActivate = false;
+
+#if WITH_EDITORONLY_DATA
+	// Blueprints saved their tuning as deltas against these, the values the constructor used to set.
+	if (HasAnyFlags(RF_ClassDefaultObject) && GetClass() == StaticClass())
+	{
+		const UShooterCharacterConfig* Defaults{ GetDefault<UShooterCharacterConfig>() };
+		ForEachMovedTuning([this, Defaults](const FProperty& Deprecated, const FProperty& Moved)
+		{
+			Deprecated.CopyCompleteValue(Deprecated.ContainerPtrToValuePtr<void>(this), Moved.ContainerPtrToValuePtr<void>(Defaults));
+		});
+	}
+#endif
 }
 
 // Called when the game starts or when spawned.
@@ -115,21 +136,110 @@ void AShooterCharacter::BeginPlay()
 
 	if (FollowCamera)
 	{
-		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
-		CameraCurrentFOV = CameraDefaultFOV;
+		Hot.CameraDefaultFOV = GetFollowCamera()->FieldOfView;
+		Hot.CameraCurrentFOV = Hot.CameraDefaultFOV;
 	}
+	Inventory.Init(FWeaponInstanceRecord(), INVENTORY_CAPACITY);
 	EquipWeapon(SpawnDefaultWeapon());
-	Inventory.Add(EquippedWeapon);
-	EquippedWeapon->SetSlotIndex(0);
-	InitializeAmmoMap();
-	GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->SetSlotIndex(0);
+		SetInventorySlot(0, EquippedWeapon->MakeInstanceRecord());
+	}
+	InitializeAmmoLedger();
+	UShooterCharacterMovementComponent* Movement{ GetShooterCharacterMovement() };
+	Movement->MaxWalkSpeed = GetConfig().BaseMovementSpeed;
+	Movement->MaxWalkSpeedCrouched = GetConfig().CrouchMovementSpeed;
+	Movement->MaxWalkSpeedAiming = GetConfig().AimMovementSpeed;
+	Movement->CrouchedHalfHeight = GetConfig().CrouchingCapsuleHalfHeight;
+	CameraBoomBaseLocation = CameraBoom->GetRelativeLocation();
+	SetTurnLookRate();
+	if (UCharacterCosmeticsSubsystem* Cosmetics = GetWorld()->GetSubsystem<UCharacterCosmeticsSubsystem>())
+	{
+		Cosmetics->RegisterCharacter(this);
+	}
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->RegisterCharacter(this);
+	}
+	WakeInterpolator(EShooterInterpolator::All);
 
 	// Hide the Belica skeleton weapons.
 	GetMesh()->HideBoneByName(TEXT("weapon"), EPhysBodyOp::PBO_None);
 	GetMesh()->HideBoneByName(TEXT("pistol"), EPhysBodyOp::PBO_None);
 
-	GetWorldTimerManager().SetTimer(CheckUnderwaterTimer, this, &AShooterCharacter::SetUnderwaterSFX, SetUnderwaterTimerRate, true, 0.5);
+	UnderwaterSoundPlayer->SetSound(UnderwaterSoundCue);
+
+	// The capsule may have been placed in water before the binding existed.
+	GetCapsuleComponent()->PhysicsVolumeChangedDelegate.AddDynamic(this, &AShooterCharacter::OnPhysicsVolumeChanged);
+	OnPhysicsVolumeChanged(GetCapsuleComponent()->GetPhysicsVolume());
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCharacterCosmeticsSubsystem* Cosmetics = GetWorld()->GetSubsystem<UCharacterCosmeticsSubsystem>())
+	{
+		Cosmetics->UnregisterCharacter(this);
+	}
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+	MigrateConfig();
+#endif
+}
+
+#if WITH_EDITORONLY_DATA
+void AShooterCharacter::MigrateConfig()
+{
+	AShooterCharacter* Archetype{ Cast<AShooterCharacter>(GetArchetype()) };
+	if (Archetype == nullptr) return;
+
+	// The archetype migrates first, so this character compares against, and inherits, its final config. Instances
+	// can't set their own config, so one still unset here is the archetype's from before it migrated.
+	Archetype->ConditionalPostLoad();
+	if (Config == nullptr && !HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		Config = Archetype->Config;
+	}
+
+	// Tuning that differs from the archetype's was overridden on this character.
+	TArray<TPair<const FProperty*, const FProperty*>, TInlineAllocator<8>> Overrides;
+	ForEachMovedTuning([this, Archetype, &Overrides](const FProperty& Deprecated, const FProperty& Moved)
+	{
+		if (!Deprecated.Identical_InContainer(this, Archetype))
+		{
+			Overrides.Emplace(&Deprecated, &Moved);
+		}
+	});
+	if (Overrides.Num() == 0) return;
+
+	// A config shared with the archetype is copied into this package first, so the overrides stay with this character.
+	if (Config == nullptr || Config == Archetype->Config)
+	{
+		UPackage* Package{ GetOutermost() };
+		const FName ConfigName{ MakeUniqueObjectName(Package, UShooterCharacterConfig::StaticClass(), *FString::Printf(TEXT("%s_Config"), *GetName())) };
+		Config = NewObject<UShooterCharacterConfig>(Package, ConfigName, RF_NoFlags, Config);
+	}
+	Config->Modify();
+	for (const TPair<const FProperty*, const FProperty*>& Override : Overrides)
+	{
+		Override.Value->CopyCompleteValue(Override.Value->ContainerPtrToValuePtr<void>(Config), Override.Key->ContainerPtrToValuePtr<void>(this));
+	}
+	MarkPackageDirty();
+	UE_LOG(LogSlime, Warning, TEXT("%s: moved %d tuning values saved on the character into %s. Resave to keep them."),
+		*GetPathName(), Overrides.Num(), *Config->GetPathName());
 }
+#endif
 
 void AShooterCharacter::MoveForward(float Value)
 {
@@ -140,6 +250,7 @@ void AShooterCharacter::MoveForward(float Value)
 		const FRotator YawRotation{ 0, Rotation.Yaw, 0 };
 		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::X) };
 		AddMovementInput(Direction, Value);
+		WakeInterpolator(EShooterInterpolator::CrosshairSpread);
 	}
 }
 
@@ -152,30 +263,31 @@ void AShooterCharacter::MoveRight(float Value)
 		const FRotator YawRotation{ 0, Rotation.Yaw, 0 };
 		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::Y) };
 		AddMovementInput(Direction, Value);
+		WakeInterpolator(EShooterInterpolator::CrosshairSpread);
 	}
 }
 
 void AShooterCharacter::TurnAtRate(float Rate)
 {
 	// Calculate delta for this frame from the rate information.
-	AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds()); // Degrees per Second * Seconds per Frame = Deg / Frame
+	AddControllerYawInput(Rate * Hot.BaseTurnRate * GetWorld()->GetDeltaSeconds()); // Degrees per Second * Seconds per Frame = Deg / Frame
 }
 
 void AShooterCharacter::LookUpAtRate(float Rate)
 {
-	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds());
+	AddControllerPitchInput(Rate * Hot.BaseLookUpRate * GetWorld()->GetDeltaSeconds());
 }
 
 void AShooterCharacter::Turn(float Rate)
 {
 	float TurnScaleFactor;
-	if (bAiming)
+	if (Hot.bAiming)
 	{
-		TurnScaleFactor = MouseAimingTurnRate;
+		TurnScaleFactor = GetConfig().MouseAimingTurnRate;
 	}
 	else
 	{
-		TurnScaleFactor = MouseHipTurnRate;
+		TurnScaleFactor = GetConfig().MouseHipTurnRate;
 	}
 	AddControllerYawInput(Rate * TurnScaleFactor);
 }
@@ -183,13 +295,13 @@ void AShooterCharacter::Turn(float Rate)
 void AShooterCharacter::LookUp(float Rate)
 {
 	float LookUpScaleFactor;
-	if (bAiming)
+	if (Hot.bAiming)
 	{
-		LookUpScaleFactor = MouseAimingLookUpRate;
+		LookUpScaleFactor = GetConfig().MouseAimingLookUpRate;
 	}
 	else
 	{
-		LookUpScaleFactor = MouseHipLookUpRate;
+		LookUpScaleFactor = GetConfig().MouseHipLookUpRate;
 	}
 	AddControllerPitchInput(Rate * LookUpScaleFactor);
 }
@@ -213,9 +325,14 @@ void AShooterCharacter::SendBullet()
 		{
 			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
 		}
+		const double ResolveStart{ UFireLatencySubsystem::Now() };
 		FVector BeamEnd;
 		bool bBeamEnd = GetBeamEndLocation(
 			SocketTransform.GetLocation(), BeamEnd);
+		if (UFireLatencySubsystem* Latency = UFireLatencySubsystem::Get(this))
+		{
+			Latency->Record(EFireLatencyStage::ShotResolve, ResolveStart);
+		}
 		if (bBeamEnd)
 		{
 			if (ImpactParticles)
@@ -255,13 +372,29 @@ void AShooterCharacter::PlayGunFireMontage()
 void AShooterCharacter::FireWeapon()
 {
 	if (EquippedWeapon == nullptr) return;
-	if (CombatState != ECombatState::ECS_Unoccupied) return;
+	if (Hot.CombatState != ECombatState::ECS_Unoccupied) return;
 	if (WeaponHasAmmo())
 	{
+		UFireLatencySubsystem* Latency{ UFireLatencySubsystem::Get(this) };
+		FireLatencyMarks.ShotStarted = UFireLatencySubsystem::Now();
+		if (Latency)
+		{
+			Latency->Record(EFireLatencyStage::InputToShot, FireLatencyMarks.ButtonPressed);
+		}
+		FireLatencyMarks.ButtonPressed = 0.0;
+
 		PlayFireSound();
 		SendBullet();
+		if (Latency)
+		{
+			Latency->Record(EFireLatencyStage::ShotToFX, FireLatencyMarks.ShotStarted);
+		}
 		PlayGunFireMontage();
 		EquippedWeapon->DecrementAmmo();
+		UpdateHUDAmmo();
+
+		// The HUD model publishes the new ammo at the end of the frame, see ForwardHUDChanges().
+		FireLatencyMarks.HUDPending = HUDModel && UShooterHUDModel::IsEnabled() ? FireLatencyMarks.ShotStarted : 0.0;
 		StartFireTimer();
 	}
 }
@@ -299,8 +432,8 @@ bool AShooterCharacter::GetBeamEndLocation(
 
 void AShooterCharacter::AimingButtonPressed()
 {
-	bAimingButtonPressed = true;
-	if (CombatState != ECombatState::ECS_Reloading)
+	Hot.bAimingButtonPressed = true;
+	if (Hot.CombatState != ECombatState::ECS_Reloading)
 	{
 		Aim();
 	}
@@ -308,116 +441,144 @@ void AShooterCharacter::AimingButtonPressed()
 
 void AShooterCharacter::AimingButtonReleased()
 {
-	bAimingButtonPressed = false;
+	Hot.bAimingButtonPressed = false;
 	StopAiming();	
 }
 
-void AShooterCharacter::SetCameraFOV(float DeltaTime)
+bool AShooterCharacter::SetCameraFOV(float DeltaTime)
 {
-	if (bAiming && CameraCurrentFOV != CameraZoomedFOV)
-	{
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraZoomedFOV, DeltaTime, ZoomInterpSpeed);
-		GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
-	}
-	if (!bAiming && CameraCurrentFOV != CameraDefaultFOV)
+	Hot.CameraCurrentFOV = FMath::FInterpTo(Hot.CameraCurrentFOV, GetTargetFOV(), DeltaTime, GetConfig().ZoomInterpSpeed);
+	return SettleCameraFOV();
+}
+
+bool AShooterCharacter::SettleCameraFOV()
+{
+	const float TargetFOV{ GetTargetFOV() };
+	const bool bConverged{ FMath::IsNearlyEqual(Hot.CameraCurrentFOV, TargetFOV, InterpolatorTolerance) };
+	if (bConverged)
 	{
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraDefaultFOV, DeltaTime, ZoomInterpSpeed);
-		GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
+		Hot.CameraCurrentFOV = TargetFOV;
 	}
+	GetFollowCamera()->SetFieldOfView(Hot.CameraCurrentFOV);
+	return bConverged;
 }
 
 /** Change turn and look sensitivity based on aiming, for game controller, but does NOT adjust mouse). */
 void AShooterCharacter::SetTurnLookRate()
 {
-	if (bAiming)
+	if (Hot.bAiming)
 	{
-		BaseTurnRate = AimingTurnRate;
-		BaseLookUpRate = AimingLookUpRate;
+		Hot.BaseTurnRate = GetConfig().AimingTurnRate;
+		Hot.BaseLookUpRate = GetConfig().AimingLookUpRate;
 	}
 	else 
 	{
-		BaseTurnRate = HipTurnRate;
-		BaseLookUpRate = HipLookUpRate;
+		Hot.BaseTurnRate = GetConfig().HipTurnRate;
+		Hot.BaseLookUpRate = GetConfig().HipLookUpRate;
 	}
 }
 
-void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime)
+bool AShooterCharacter::CalculateCrosshairSpread(float DeltaTime)
 {
-	FVector2D WalkSpeedRange{ 0.f, 600.f };  // Since called on tick, magic numbers are most performant.
-	FVector2D VelocityMultiplierRange{ 0.f, 1.0f };
 	FVector LateralVelocity{ GetVelocity() };
 	LateralVelocity.Z = 0;
 
 	// Calculate velocity factor.
-	CrosshairVelocityFactor = FMath::GetMappedRangeValueClamped(WalkSpeedRange, VelocityMultiplierRange, LateralVelocity.Size());
+	Hot.CrosshairVelocityFactor = FMath::Clamp(LateralVelocity.Size() / ShooterCrosshair::MaxVelocitySpeed, 0.f, 1.f);
 
 	// Calculate in air factor.
-	if (GetCharacterMovement()->IsFalling())
+	const bool bFalling{ GetCharacterMovement()->IsFalling() };
+	if (bFalling)
 	{
-		CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 2.25f, DeltaTime, 2.25f);  // Spread crosshairs slowly while in air.
+		Hot.CrosshairInAirFactor = FMath::FInterpTo(Hot.CrosshairInAirFactor, ShooterCrosshair::InAirTarget, DeltaTime, ShooterCrosshair::InAirSpreadSpeed);
 	}
 	else
 	{
-		CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 0.f, DeltaTime, 30.f);  // Return crosshairs quickly when on ground.
+		Hot.CrosshairInAirFactor = FMath::FInterpTo(Hot.CrosshairInAirFactor, 0.f, DeltaTime, ShooterCrosshair::InAirReturnSpeed);
 	}
 
 	// Calculate aiming factor.
-	if (bAiming)
+	Hot.CrosshairAimFactor = FMath::FInterpTo(Hot.CrosshairAimFactor, Hot.bAiming ? ShooterCrosshair::AimTarget : 0.f, DeltaTime, ShooterCrosshair::AimSpeed);
+
+	// Calculate shooting factor.
+	if (Hot.bFiringBullet)  
 	{
-		CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, -0.4f, DeltaTime, 30.f);  // Tighten crosshairs quickly a small amount.
+		Hot.CrosshairShootingFactor = FMath::FInterpTo(Hot.CrosshairShootingFactor, ShooterCrosshair::ShootingTarget, DeltaTime, ShooterCrosshair::ShootingSpreadSpeed);
 	}
 	else
 	{
-		CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, 0.f, DeltaTime, 30.f);  // Return crosshairs quickly.
+		Hot.CrosshairShootingFactor = FMath::FInterpTo(Hot.CrosshairShootingFactor, 0.f, DeltaTime, ShooterCrosshair::ShootingReturnSpeed);
 	}
+	
+	return SettleCrosshairSpread(bFalling);
+}
 
-	// Calculate shooting factor.
-	if (bFiringBullet)  
-	{
-		CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.7f, DeltaTime, 60.f);  // Widen crosshairs very quickly a small amount.
-	}
-	else
+bool AShooterCharacter::SettleCrosshairSpread(bool bFalling)
+{
+	// Settled once standing still on the ground with every factor at its target; the next move, jump, aim or shot wakes it.
+	const float AimTarget{ Hot.bAiming ? ShooterCrosshair::AimTarget : 0.f };
+	const float ShootingTarget{ Hot.bFiringBullet ? ShooterCrosshair::ShootingTarget : 0.f };
+	const bool bConverged{ !bFalling
+		&& Hot.CrosshairVelocityFactor == 0.f
+		&& FMath::IsNearlyZero(Hot.CrosshairInAirFactor, InterpolatorTolerance)
+		&& FMath::IsNearlyEqual(Hot.CrosshairAimFactor, AimTarget, InterpolatorTolerance)
+		&& FMath::IsNearlyEqual(Hot.CrosshairShootingFactor, ShootingTarget, InterpolatorTolerance) };
+	if (bConverged)
 	{
-		CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.f, DeltaTime, 45.f);  // Return crosshairs quickly.
+		Hot.CrosshairInAirFactor = 0.f;
+		Hot.CrosshairAimFactor = AimTarget;
+		Hot.CrosshairShootingFactor = ShootingTarget;
 	}
 	
-	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimFactor + CrosshairShootingFactor;
+	Hot.CrosshairSpreadMultiplier = ShooterCrosshair::BaseSpread + Hot.CrosshairVelocityFactor + Hot.CrosshairInAirFactor + Hot.CrosshairAimFactor + Hot.CrosshairShootingFactor;
+	return bConverged;
 }
 
 void AShooterCharacter::StartCrosshairBulletFireTimer()
 {
-	bFiringBullet = true;
-	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AShooterCharacter::FinishCrosshairBulletFireTimer, ShootTimeDuration);
+	Hot.bFiringBullet = true;
+	WakeInterpolator(EShooterInterpolator::CrosshairSpread);
+	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AShooterCharacter::FinishCrosshairBulletFireTimer, GetConfig().ShootTimeDuration);
 }
 
 void AShooterCharacter::FinishCrosshairBulletFireTimer()
 {
-	bFiringBullet = false;
+	Hot.bFiringBullet = false;
+	WakeInterpolator(EShooterInterpolator::CrosshairSpread);
 }
 
 void AShooterCharacter::FireButtonPressed()
 {
-	bFireButtonPressed = true;
+	Hot.bFireButtonPressed = true;
+	FireLatencyMarks.ButtonPressed = UFireLatencySubsystem::Now();
 	FireWeapon();
 }
 
 void AShooterCharacter::FireButtonReleased()
 {
-	bFireButtonPressed = false;	
+	Hot.bFireButtonPressed = false;
+	// A press that never got a shot off, e.g. during a reload, isn't a latency.
+	FireLatencyMarks.ButtonPressed = 0.0;
 }
 
 void AShooterCharacter::StartFireTimer()
 {
-	CombatState = ECombatState::ECS_FireTimerInProgress;
-	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AShooterCharacter::AutoFireReset, AutomaticFireRate);
+	SetCombatState(ECombatState::ECS_FireTimerInProgress);
+	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AShooterCharacter::AutoFireReset, GetConfig().AutomaticFireRate);
+	FireLatencyMarks.AutoFireDue = UFireLatencySubsystem::Now() + GetConfig().AutomaticFireRate;
 }
 
 void AShooterCharacter::AutoFireReset()
 {
-	CombatState = ECombatState::ECS_Unoccupied;
+	if (UFireLatencySubsystem* Latency = UFireLatencySubsystem::Get(this))
+	{
+		Latency->Record(EFireLatencyStage::AutoFireTimerLateness, FireLatencyMarks.AutoFireDue);
+	}
+	FireLatencyMarks.AutoFireDue = 0.0;
+	SetCombatState(ECombatState::ECS_Unoccupied);
 	if (WeaponHasAmmo())
 	{
-		if (bFireButtonPressed)
+		if (Hot.bFireButtonPressed)
 		{
 			FireWeapon();
 		}
@@ -428,7 +589,7 @@ void AShooterCharacter::AutoFireReset()
 	}
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult)
+bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
 {
 	// Get current size of the viewport.
 	FVector2D ViewportSize;
@@ -449,110 +610,155 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult)
 		CrosshairWorldPosition,
 		CrosshairWorldDirection);
 
-	if (bScreenToWorld)
+	if(bScreenToWorld)
 	{
 		const FVector Start{ CrosshairWorldPosition };
 		const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
+		OutHitLocation = End;
 		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECC_Visibility);
 		if (OutHitResult.bBlockingHit)
 		{
+			OutHitLocation = OutHitResult.Location;
 			return true;
 		}
 	}
 	return false;
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+void AShooterCharacter::TraceForItems()
 {
-	// Get current size of the viewport.
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport)
+	TraceHitItem = Hot.bShouldTraceForItems ? FindTargetItem() : nullptr;
+
+	// Handle Inventory Highlights.
+	const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
+	if (TraceHitWeapon)
 	{
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
+		if (HighlightedSlot == -1)
+		{
+			BeginHighlightInventorySlot();
+		}
+	}
+	else
+	{
+		if (HighlightedSlot != -1)
+		{
+			EndHighlightInventorySlot();
+		}
 	}
 
-	// Get screen space location of cross hairs.
-	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
+	// Begin Item Highlight and Show Widget.
+	if (TraceHitItem)
+	{
+		TraceHitItem->EnableCustomDepth();
 
-	// Get world position and direction of cross hairs.
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
-		UGameplayStatics::GetPlayerController(this, 0),
-		CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirection);
+		// Toggle Item's widget text prompt ("Pickup" vs "Swap") based on whether our inventory is full.
+		TraceHitItem->SetWidgetTextIsSwap(GetEmptyInventorySlot() == -1);
+		ShowPickupWidget(TraceHitItem);
+	}
+	else
+	{
+		HidePickupWidget();
+	}
 
-	if(bScreenToWorld)
+	// End Item Highlight.
+	if (TraceHitItemLastFrame && TraceHitItem != TraceHitItemLastFrame)
 	{
-		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50'000.f };
-		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECC_Visibility);
-		if (OutHitResult.bBlockingHit)
-		{
-			OutHitLocation = OutHitResult.Location;
-			return true;
-		}
+		TraceHitItemLastFrame->DisableCustomDepth();
 	}
-	return false;
+	TraceHitItemLastFrame = TraceHitItem;
 }
 
-void AShooterCharacter::TraceForItems()
+AItem* AShooterCharacter::FindTargetItem() const
 {
-	if (bShouldTraceForItems)
+	SCOPE_CYCLE_COUNTER(STAT_FindTargetItem);
+
+	const UItemWorldSubsystem* ItemSubsystem{ GetWorld()->GetSubsystem<UItemWorldSubsystem>() };
+	if (Controller == nullptr || ItemSubsystem == nullptr) return nullptr;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	const FVector ViewDirection{ ViewRotation.Vector() };
+
+	TArray<AItem*> Candidates;
+	ItemSubsystem->QueryGroundItems(GetActorLocation(), GetConfig().TargetingRadius, Candidates);
+
+	// Lower is better: 0 is dead center and right at our feet, 1 + DistanceWeight is at the edge of the cone and radius.
+	const float MinConeCos{ FMath::Cos(FMath::DegreesToRadians(GetConfig().TargetingConeAngle)) };
+	AItem* BestItem{ nullptr };
+	float BestScore{ TNumericLimits<float>::Max() };
+	for (AItem* Item : Candidates)
 	{
-		FHitResult ItemTraceHitResult;
-		TraceUnderCrosshairs(ItemTraceHitResult);
-		if (ItemTraceHitResult.bBlockingHit)
+		const FVector ToItem{ Item->GetTargetLocation() - ViewLocation };
+		const float ConeCos{ FVector::DotProduct(ToItem.GetSafeNormal(), ViewDirection) };
+		if (ConeCos < MinConeCos) continue;
+
+		const float AngleScore{ (1.f - ConeCos) / FMath::Max(1.f - MinConeCos, KINDA_SMALL_NUMBER) };
+		const float DistanceScore{ FVector::Dist(Item->GetActorLocation(), GetActorLocation()) / GetConfig().TargetingRadius };
+		const float Score{ AngleScore + DistanceScore * GetConfig().TargetingDistanceWeight };
+		if (Score < BestScore)
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceHitResult.GetActor());
-			
-			// Handle Inventory Highlights.
-			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
-			if(TraceHitWeapon)
-			{
-				if (HighlightedSlot == -1)
-				{
-					BeginHighlightInventorySlot();
-				}
-				
-			}
-			else
-			{
-				if (HighlightedSlot != -1)
-				{
-					EndHighlightInventorySlot();
-				}
-			}
-			
-			// Begin Item Highlight and Show Widget.
-			if (TraceHitItem && TraceHitItem->GetPickupWidget())
-			{
-				TraceHitItem->EnableCustomDepth();
-				TraceHitItem->GetPickupWidget()->SetVisibility(true);
+			BestScore = Score;
+			BestItem = Item;
+		}
+	}
+	if (BestItem == nullptr) return nullptr;
 
-				// Toggle Item's widget text prompt ("Pickup" vs "Swap") based on whether our inventory is full.
-				Inventory.Num() == INVENTORY_CAPACITY ? TraceHitItem->SetWidgetTextIsSwap(true) : TraceHitItem->SetWidgetTextIsSwap(false);
-			}
+	// Only the winner gets an occlusion trace, so items behind walls can't be picked up. Only level geometry occludes:
+	// on the visibility channel the collision boxes of the items piled around the winner would block it.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ItemTargetingOcclusion), false, this);
+	QueryParams.AddIgnoredActor(BestItem);
+	if (EquippedWeapon)
+	{
+		QueryParams.AddIgnoredActor(EquippedWeapon);
+	}
+	const bool bOccluded{ GetWorld()->LineTraceTestByObjectType(ViewLocation, BestItem->GetTargetLocation(),
+		FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams) };
+	return bOccluded ? nullptr : BestItem;
+}
 
-			// End Item Highlight and Hide Widget.
-			if (TraceHitItemLastFrame)
-			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					TraceHitItemLastFrame->DisableCustomDepth();
-					TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
-				}
-			}
-			TraceHitItemLastFrame = TraceHitItem;
-		}
+void AShooterCharacter::ShowPickupWidget(AItem* Item)
+{
+	UWidgetComponent* Widget{ GetOrCreatePickupWidget() };
+	if (Widget == nullptr) return;
+
+	Widget->SetWorldLocation(Item->GetPickupWidgetLocation());
+
+	// Only refill when the item, its count or its prompt changed, the widget keeps its data otherwise.
+	UPickupWidget* PickupUserWidget{ Cast<UPickupWidget>(Widget->GetUserWidgetObject()) };
+	if (PickupUserWidget && (Item != PickupWidgetItem || !Widget->IsVisible() || !PickupUserWidget->IsUpToDate(Item)))
+	{
+		PickupUserWidget->SetItem(Item);
 	}
-	else if(TraceHitItemLastFrame)
+	PickupWidgetItem = Item;
+	Widget->SetVisibility(true);
+}
+
+void AShooterCharacter::HidePickupWidget()
+{
+	if (PickupWidget)
 	{
-		TraceHitItemLastFrame->DisableCustomDepth();
-		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+		PickupWidget->SetVisibility(false);
 	}
+	PickupWidgetItem = nullptr;
+}
+
+UWidgetComponent* AShooterCharacter::GetOrCreatePickupWidget()
+{
+	if (PickupWidget == nullptr && PickupWidgetClass && IsLocallyControlled())
+	{
+		PickupWidget = NewObject<UWidgetComponent>(this, TEXT("PickupWidget"));
+		PickupWidget->SetWidgetSpace(EWidgetSpace::Screen);
+		PickupWidget->SetWidgetClass(PickupWidgetClass);
+		PickupWidget->SetDrawAtDesiredSize(true);
+		PickupWidget->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		PickupWidget->SetGenerateOverlapEvents(false);
+		PickupWidget->SetupAttachment(GetRootComponent());
+		PickupWidget->SetUsingAbsoluteLocation(true);  // Placed at the traced item, not the character.
+		PickupWidget->SetVisibility(false);
+		PickupWidget->RegisterComponent();
+	}
+	return PickupWidget;
 }
 
 AWeapon* AShooterCharacter::SpawnDefaultWeapon()
@@ -583,39 +789,79 @@ void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip)
 			HandSocket->AttachActor(WeaponToEquip, GetMesh());
 		}
 		
-		// Broadcast to HUD which inventory item was selected and which to select next.
-		if (EquippedWeapon == nullptr) 
-		{
-			EquipItemDelegate.Broadcast(-1, WeaponToEquip->GetSlotIndex());
-		}
-		else  
-		{
-			EquipItemDelegate.Broadcast(EquippedWeapon->GetSlotIndex(), WeaponToEquip->GetSlotIndex());
-		}
+		// Tell the HUD which inventory item was selected and which to select next.
+		NotifyEquippedSlot(EquippedWeapon ? EquippedWeapon->GetSlotIndex() : -1, WeaponToEquip->GetSlotIndex());
 
 		// Set... 
 		EquippedWeapon = WeaponToEquip;
 		EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
+		UpdateHUDAmmo();
+	}
+}
+
+void AShooterCharacter::EquipInventorySlot(int32 SlotIndex)
+{
+	if (!IsInventorySlotOccupied(SlotIndex)) return;
+
+	const FWeaponInstanceRecord& Record{ Inventory[SlotIndex] };
+	if (EquippedWeapon && EquippedWeapon->GetClass() == Record.WeaponClass)
+	{
+		// Same actor, new weapon: nothing is spawned or destroyed.
+		NotifyEquippedSlot(EquippedWeapon->GetSlotIndex(), SlotIndex);
+		EquippedWeapon->ApplyInstanceRecord(Record);
+		EquippedWeapon->SetSlotIndex(SlotIndex);
+		UpdateHUDAmmo();
+		if (EquippedWeapon->GetEquipSound())
+		{
+			UGameplayStatics::PlaySound2D(this, EquippedWeapon->GetEquipSound());
+		}
+		return;
+	}
+
+	// A different class has different components, so it needs its own actor.
+	AWeapon* Weapon{ SpawnWeaponFromRecord(Record) };
+	if (Weapon == nullptr) return;
+
+	AWeapon* PreviousWeapon{ EquippedWeapon };
+	Weapon->SetSlotIndex(SlotIndex);
+	EquipWeapon(Weapon);
+	if (PreviousWeapon)
+	{
+		PreviousWeapon->Destroy();
 	}
 }
 
+AWeapon* AShooterCharacter::SpawnWeaponFromRecord(const FWeaponInstanceRecord& Record)
+{
+	if (!Record.IsSet()) return nullptr;
+
+	FItemSpawnParams Params;
+	Params.Rarity = Record.Rarity;
+	Params.SubType = static_cast<uint8>(Record.WeaponType);
+	AWeapon* Weapon{ Cast<AWeapon>(AItem::SpawnItem(GetWorld(), Record.WeaponClass, GetActorTransform(), Params)) };
+	if (Weapon == nullptr) return nullptr;
+
+	Weapon->ApplyInstanceRecord(Record);
+	return Weapon;
+}
+
 void AShooterCharacter::DropWeapon()
 {
 	if (EquippedWeapon)
 	{
 		const FDetachmentTransformRules DetachmentTransformRules(EDetachmentRule::KeepWorld, true);
 		EquippedWeapon->GetItemMesh()->DetachFromComponent(DetachmentTransformRules);
-		EquippedWeapon->SetItemState(EItemState::EIS_Falling);
 		EquippedWeapon->ThrowWeapon();
 	}
 }
 
 void AShooterCharacter::SelectButtonPressed()
 {
-	if (CombatState != ECombatState::ECS_Unoccupied) return;
+	if (Hot.CombatState != ECombatState::ECS_Unoccupied) return;
 	if (TraceHitItem)
 	{
 		TraceHitItem->BeginEquip(this);
+		HidePickupWidget();
 	}
 }
 
@@ -631,10 +877,10 @@ void AShooterCharacter::SwapWeapon(AWeapon* Weapon)
 	EquipWeapon(Weapon);
 }
 
-void AShooterCharacter::InitializeAmmoMap()
+void AShooterCharacter::InitializeAmmoLedger()
 {
-	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EAmmoType::EAT_AR, StartingARAmmo);
+	AmmoLedger.Set(EAmmoType::EAT_9mm, GetConfig().Starting9mmAmmo);
+	AmmoLedger.Set(EAmmoType::EAT_AR, GetConfig().StartingARAmmo);
 }
 
 bool AShooterCharacter::WeaponHasAmmo()
@@ -648,16 +894,16 @@ bool AShooterCharacter::WeaponHasAmmo()
 
 void AShooterCharacter::ReloadWeapon()
 {
-	if (CombatState != ECombatState::ECS_Unoccupied) return;
+	if (Hot.CombatState != ECombatState::ECS_Unoccupied) return;
 	if (EquippedWeapon == nullptr) return;
 
 	if (CarryingAmmo())  
 	{
-		if (bAiming)
+		if (Hot.bAiming)
 		{
 			StopAiming();
 		}
-		CombatState = ECombatState::ECS_Reloading;
+		SetCombatState(ECombatState::ECS_Reloading);
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 		if (AnimInstance && ReloadMontage)
 		{
@@ -676,36 +922,18 @@ void AShooterCharacter::FinishReloading()
 {
 	if (EquippedWeapon == nullptr) return;
 
-	// Update AmmoMap.
-	const auto AmmoType{ EquippedWeapon->GetAmmoType() };
-	if (AmmoMap.Contains(AmmoType))
-	{
-		int32 CarriedAmmo = AmmoMap[AmmoType];
-
-		// Calculate ammo space left in the equipped weapon.
-		const int32 MagEmptySpace = EquippedWeapon->GetMagazineCapacity() - EquippedWeapon->GetAmmo();
-
-		if (MagEmptySpace > CarriedAmmo)
-		{
-			// Dump all ammo into weapon and update.
-			EquippedWeapon->ReloadAmmo(CarriedAmmo);
-			CarriedAmmo = 0;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		}
-		else
-		{
-			// Fill mag and update.
-			EquippedWeapon->ReloadAmmo(MagEmptySpace);
-			CarriedAmmo -= MagEmptySpace;
-			AmmoMap.Add(AmmoType, CarriedAmmo);			
-		}
-	}
+	// Fill the magazine from carried ammo, or load all of it if that doesn't fill it.
+	EquippedWeapon->ReloadAmmo(AmmoLedger.Reload(
+		EquippedWeapon->GetAmmoType(),
+		EquippedWeapon->GetAmmo(),
+		EquippedWeapon->GetMagazineCapacity()));
 
 	// Update State.
-	CombatState = ECombatState::ECS_Unoccupied;
+	SetCombatState(ECombatState::ECS_Unoccupied);
+	UpdateHUDAmmo();
 
 	// Reload may override aiming, so check if still aiming after reload is finished.
-	if (bAimingButtonPressed)
+	if (Hot.bAimingButtonPressed)
 	{
 		Aim();
 	}
@@ -713,20 +941,14 @@ void AShooterCharacter::FinishReloading()
 
 void AShooterCharacter::FinishEquipping()
 {
-	CombatState = ECombatState::ECS_Unoccupied;
+	SetCombatState(ECombatState::ECS_Unoccupied);
 }
 
 bool AShooterCharacter::CarryingAmmo()
 {
 	if (EquippedWeapon == nullptr) return false;
 
-	const auto AmmoType = EquippedWeapon->GetAmmoType();
-
-	if (AmmoMap.Contains(AmmoType))
-	{
-		return AmmoMap[AmmoType] > 0;
-	}
-	return false;
+	return AmmoLedger.Has(EquippedWeapon->GetAmmoType());
 }
 
 void AShooterCharacter::GrabClip()
@@ -758,58 +980,170 @@ void AShooterCharacter::CrouchButtonPressed()
 {
 	if ( ! GetCharacterMovement()->IsFalling())  // IsFalling() returns true if character is in the air, so "If (not in air...), do..."
 	{
-		bCrouching = ! bCrouching;  // Toggle boolean value every touch.
+		// Toggle every touch. The movement component resizes the capsule, and waits for room to stand up.
+		if (GetCharacterMovement()->bWantsToCrouch)
+		{
+			UnCrouch();
+		}
+		else
+		{
+			Crouch();
+		}
 	}
-	if (bCrouching)
+}
+
+void AShooterCharacter::Jump()
+{
+	if (bIsCrouched)
 	{
-		GetCharacterMovement()->MaxWalkSpeed = CrouchMovementSpeed;
+		UnCrouch();
 	}
 	else
 	{
-		GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
+		Super::Jump();
 	}
 }
 
-void AShooterCharacter::InterpCapsuleHalfHeight(float DeltaTime)
+void AShooterCharacter::OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
 {
-	float TargetCapsuleHalfHeight;
-	if (bCrouching)
+	Super::OnStartCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
+
+	// The capsule's center, and the camera boom with it, just dropped by ScaledHalfHeightAdjust.
+	Hot.CrouchCameraOffset += ScaledHalfHeightAdjust;
+	WakeInterpolator(EShooterInterpolator::CrouchCameraOffset);
+}
+
+void AShooterCharacter::OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
+{
+	Super::OnEndCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
+
+	Hot.CrouchCameraOffset -= ScaledHalfHeightAdjust;
+	WakeInterpolator(EShooterInterpolator::CrouchCameraOffset);
+}
+
+bool AShooterCharacter::InterpCrouchCameraOffset(float DeltaTime)
+{
+	Hot.CrouchCameraOffset = FMath::FInterpTo(Hot.CrouchCameraOffset, 0.f, DeltaTime, 20.f);
+	const bool bConverged{ FMath::IsNearlyZero(Hot.CrouchCameraOffset, InterpolatorTolerance) };
+	if (bConverged)
 	{
-		TargetCapsuleHalfHeight = CrouchingCapsuleHalfHeight;
+		Hot.CrouchCameraOffset = 0.f;
 	}
-	else
+
+	// Only the boom moves: no collision, and the capsule keeps the size the movement component gave it.
+	CameraBoom->SetRelativeLocation(CameraBoomBaseLocation + FVector{ 0.f, 0.f, Hot.CrouchCameraOffset });
+	return bConverged;
+}
+
+void AShooterCharacter::WakeInterpolator(EShooterInterpolator Interpolator)
+{
+	Hot.ActiveInterpolators |= Interpolator;
+	if (GetTickedInterpolators() != EShooterInterpolator::None && !IsActorTickEnabled())
 	{
-		TargetCapsuleHalfHeight = StandingCapsuleHalfHeight;
+		SetActorTickEnabled(true);
 	}
-	const float InterpHalfHeight { FMath::FInterpTo(GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), TargetCapsuleHalfHeight, DeltaTime, 20.f) };
+}
 
-	// Raise or lower mesh by the difference between the target capsule height and the current height - keeps crouching character on the ground, not under it.
-	// Delta is negative if crouching, positive if standing - negate the delta to raise / lower mesh. 
-	const float DeltaCapsuleHalfHeight { InterpHalfHeight - GetCapsuleComponent()->GetScaledCapsuleHalfHeight() };
-	const FVector MeshOffset{ 0.f, 0.f, -DeltaCapsuleHalfHeight };
-	GetMesh()->AddLocalOffset(MeshOffset);
-	
-	GetCapsuleComponent()->SetCapsuleHalfHeight(InterpHalfHeight);
+EShooterInterpolator AShooterCharacter::GetTickedInterpolators() const
+{
+	return UCharacterCosmeticsSubsystem::IsBatchingEnabled()
+		? Hot.ActiveInterpolators & ~EShooterInterpolator::Cosmetics
+		: Hot.ActiveInterpolators;
 }
 
-void AShooterCharacter::Aim()
+void AShooterCharacter::TickInterpolators(float DeltaTime, EShooterInterpolator Interpolators)
 {
-	bAiming = true;
-	if (!bCrouching)
+	SCOPE_CYCLE_COUNTER(STAT_CharacterInterpolators);
+
+	const EShooterInterpolator Awake{ Hot.ActiveInterpolators & Interpolators };
+	if (EnumHasAnyFlags(Awake, EShooterInterpolator::CameraFOV) && SetCameraFOV(DeltaTime))
+	{
+		Hot.ActiveInterpolators &= ~EShooterInterpolator::CameraFOV;
+	}
+	if (EnumHasAnyFlags(Awake, EShooterInterpolator::CrosshairSpread) && CalculateCrosshairSpread(DeltaTime))
 	{
-		GetCharacterMovement()->MaxWalkSpeed = AimMovementSpeed;
+		Hot.ActiveInterpolators &= ~EShooterInterpolator::CrosshairSpread;
+	}
+	if (EnumHasAnyFlags(Awake, EShooterInterpolator::CrouchCameraOffset) && InterpCrouchCameraOffset(DeltaTime))
+	{
+		Hot.ActiveInterpolators &= ~EShooterInterpolator::CrouchCameraOffset;
 	}
 }
 
-void AShooterCharacter::StopAiming()
+void AShooterCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// Jumping, falling off a ledge and landing all change the in-air spread.
+	WakeInterpolator(EShooterInterpolator::CrosshairSpread);
+}
+
+void AShooterCharacter::GatherCosmetics(FCharacterCosmeticsBatch& Batch, int32 Index) const
 {
-	bAiming = false;
-	if (!bCrouching)
+	FVector LateralVelocity{ GetVelocity() };
+	LateralVelocity.Z = 0;
+	const bool bFalling{ GetCharacterMovement()->IsFalling() };
+
+	// Targets and speeds as CalculateCrosshairSpread() and SetCameraFOV() pick them.
+	Batch.Falling[Index] = bFalling;
+	Batch.LateralSpeed[Index] = LateralVelocity.Size();
+	Batch.InAirFactor[Index] = Hot.CrosshairInAirFactor;
+	Batch.InAirTarget[Index] = bFalling ? ShooterCrosshair::InAirTarget : 0.f;
+	Batch.InAirSpeed[Index] = bFalling ? ShooterCrosshair::InAirSpreadSpeed : ShooterCrosshair::InAirReturnSpeed;
+	Batch.AimFactor[Index] = Hot.CrosshairAimFactor;
+	Batch.AimTarget[Index] = Hot.bAiming ? ShooterCrosshair::AimTarget : 0.f;
+	Batch.ShootingFactor[Index] = Hot.CrosshairShootingFactor;
+	Batch.ShootingTarget[Index] = Hot.bFiringBullet ? ShooterCrosshair::ShootingTarget : 0.f;
+	Batch.ShootingSpeed[Index] = Hot.bFiringBullet ? ShooterCrosshair::ShootingSpreadSpeed : ShooterCrosshair::ShootingReturnSpeed;
+	Batch.FOV[Index] = Hot.CameraCurrentFOV;
+	Batch.FOVTarget[Index] = GetTargetFOV();
+	Batch.FOVSpeed[Index] = GetConfig().ZoomInterpSpeed;
+}
+
+void AShooterCharacter::ScatterCosmetics(const FCharacterCosmeticsBatch& Batch, int32 Index)
+{
+	if (EnumHasAnyFlags(Batch.Interpolators[Index], EShooterInterpolator::CrosshairSpread))
+	{
+		Hot.CrosshairVelocityFactor = Batch.VelocityFactor[Index];
+		Hot.CrosshairInAirFactor = Batch.InAirFactor[Index];
+		Hot.CrosshairAimFactor = Batch.AimFactor[Index];
+		Hot.CrosshairShootingFactor = Batch.ShootingFactor[Index];
+		if (SettleCrosshairSpread(Batch.Falling[Index]))
+		{
+			Hot.ActiveInterpolators &= ~EShooterInterpolator::CrosshairSpread;
+		}
+	}
+	if (EnumHasAnyFlags(Batch.Interpolators[Index], EShooterInterpolator::CameraFOV))
 	{
-		GetCharacterMovement()->MaxWalkSpeed = BaseMovementSpeed;
+		Hot.CameraCurrentFOV = Batch.FOV[Index];
+		if (SettleCameraFOV())
+		{
+			Hot.ActiveInterpolators &= ~EShooterInterpolator::CameraFOV;
+		}
 	}
 }
 
+void AShooterCharacter::OnCosmeticsBatchingChanged()
+{
+	WakeInterpolator(Hot.ActiveInterpolators);
+}
+
+void AShooterCharacter::Aim()
+{
+	Hot.bAiming = true;
+	GetShooterCharacterMovement()->SetWantsToAim(true);
+	SetTurnLookRate();
+	WakeInterpolator(EShooterInterpolator::CameraFOV | EShooterInterpolator::CrosshairSpread);
+}
+
+void AShooterCharacter::StopAiming()
+{
+	Hot.bAiming = false;
+	GetShooterCharacterMovement()->SetWantsToAim(false);
+	SetTurnLookRate();
+	WakeInterpolator(EShooterInterpolator::CameraFOV | EShooterInterpolator::CrosshairSpread);
+}
+
 void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 {
 	// Play SFX
@@ -818,19 +1152,24 @@ void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 		UGameplayStatics::PlaySound2D(this, Ammo->GetEquipSound());
 	}
 	
-	// Check if AmmoMap contains correct ammo, get the amount, and update it.
-	if (AmmoMap.Find(Ammo->GetAmmoType()))
-	{
-		int32 AmmoCount{ AmmoMap[Ammo->GetAmmoType()] };
-		AmmoCount += Ammo->GetItemCount();
-		AmmoMap[Ammo->GetAmmoType()] = AmmoCount;
-	}
+	// Take what fits. Ammo::BeginEquip() split off what didn't when the pickup started, but another stack picked up
+	// since then may have used some of that space.
+	const int32 Taken{ AmmoLedger.Pickup(Ammo->GetAmmoType(), Ammo->GetItemCount(), GetConfig().MaxCarriedAmmo) };
+	UpdateHUDAmmo();
 
 	// For convenience, if equipped weapon is empty, and ammo pickup matches, reload.
-	if (EquippedWeapon->GetAmmo() == 0 && EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType())
+	if (EquippedWeapon && EquippedWeapon->GetAmmo() == 0 && EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType())
 	{
 		ReloadWeapon();
 	}
+
+	// Drop whatever didn't fit back to the ground.
+	if (Taken < Ammo->GetItemCount())
+	{
+		Ammo->SetItemCount(Ammo->GetItemCount() - Taken);
+		Ammo->Launch(FVector::ZeroVector);
+		return;
+	}
 	Ammo->Destroy();
 }
 
@@ -840,109 +1179,132 @@ EPhysicalSurface AShooterCharacter::GetFootstepSurface()
 	{
 		return EPS_UNDERWATER;
 	}
-	FHitResult HitResult;
-	const FVector StartLocation{ GetActorLocation() };
-	const FVector EndLocation = StartLocation + FVector(0.f, 0.f, -400.f);
-	FCollisionQueryParams QueryParams;
+
+	// In the air, keep the surface of the last floor for the landing.
+	const FFindFloorResult& Floor{ GetCharacterMovement()->CurrentFloor };
+	const UPrimitiveComponent* FloorComponent{ Floor.HitResult.GetComponent() };
+	const int32 FloorFaceIndex{ Floor.HitResult.FaceIndex };
+	if (!Floor.bBlockingHit || (FloorComponent == FootstepFloorComponent.Get() && FloorFaceIndex == FootstepFloorFaceIndex))
+	{
+		return FootstepSurface;
+	}
+	FootstepFloorComponent = FloorComponent;
+	FootstepFloorFaceIndex = FloorFaceIndex;
+
+	// The floor sweep doesn't return physical materials, and a multi-material mesh has one per section, so a short trace
+	// through the floor point reads the one underfoot. Landscapes are split into collision components, which bounds how
+	// stale a layer can get.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FootstepSurface), false, this);
 	QueryParams.bReturnPhysicalMaterial = true;
-	GetWorld()->LineTraceSingleByChannel(HitResult, StartLocation, EndLocation, ECollisionChannel::ECC_Visibility, QueryParams);
-	return UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get());
+	const FVector FloorPoint{ Floor.HitResult.ImpactPoint };
+	FHitResult Hit;
+	if (GetWorld()->LineTraceSingleByChannel(Hit, FloorPoint + FVector(0.f, 0.f, 10.f), FloorPoint - FVector(0.f, 0.f, 10.f),
+		GetCharacterMovement()->UpdatedComponent->GetCollisionObjectType(), QueryParams))
+	{
+		FootstepSurface = UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get());
+	}
+	return FootstepSurface;
 }
 
-void AShooterCharacter::SetUnderwater()
+void AShooterCharacter::PlayFootstep(const FVector& Location, float VolumeMultiplier)
 {
-	FHitResult HitResult;
-	const FVector StartLocation{ GetActorLocation() };
-	const FVector EndLocation{ StartLocation + FVector(0.f, 0.f, 3000.f) };
-	FCollisionQueryParams QueryParams;
-	QueryParams.bReturnPhysicalMaterial = true;
-	bool bTraceHit = GetWorld()->LineTraceSingleByChannel(HitResult, StartLocation, EndLocation, ECollisionChannel::ECC_Visibility, QueryParams);
-	if (bTraceHit && UPhysicalMaterial::DetermineSurfaceType(HitResult.PhysMaterial.Get()) == EPS_WATER && HitResult.Location.Z > GetFollowCamera()->GetComponentLocation().Z + 25)
+	if (FootstepBank == nullptr) return;
+
+	if (USoundBase* Sound = FootstepBank->GetSound(GetFootstepSurface()))
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, Sound, Location, VolumeMultiplier);
+	}
+}
+
+void AShooterCharacter::OnPhysicsVolumeChanged(APhysicsVolume* NewVolume)
+{
+	WaterVolume = Cast<AShooterWaterVolume>(NewVolume);
+	if (WaterVolume)
 	{
-		bUnderwater = true;
+		GetWorldTimerManager().SetTimer(CheckUnderwaterTimer, this, &AShooterCharacter::UpdateUnderwater, GetConfig().SetUnderwaterTimerRate, true, 0.f);
 	}
 	else
 	{
-		bUnderwater = false;
+		GetWorldTimerManager().ClearTimer(CheckUnderwaterTimer);
+		SetUnderwater(false);
 	}
 }
 
-void AShooterCharacter::SetUnderwaterSFX()
+void AShooterCharacter::UpdateUnderwater()
 {
-	if  (bUnderwater)
+	SetUnderwater(WaterVolume && WaterVolume->IsBelowSurface(GetFollowCamera()->GetComponentLocation(), GetConfig().UnderwaterCameraDepth));
+
+	// Restart the cue if it has played out while still under water.
+	if (bUnderwater && UnderwaterSoundCue && !UnderwaterSoundPlayer->IsPlaying())
 	{
-		if (UnderwaterSoundCue)
-		{
-			if (!UnderwaterSoundPlayer || UnderwaterSoundPlayer->GetPlayState() == EAudioComponentPlayState::Stopped)
-			{
-				UnderwaterSoundPlayer = UGameplayStatics::SpawnSoundAttached(UnderwaterSoundCue, GetMesh());
-			}
-		}
+		UnderwaterSoundPlayer->Play();
 	}
-	else
+}
+
+void AShooterCharacter::SetUnderwater(bool bNewUnderwater)
+{
+	if (bUnderwater == bNewUnderwater) return;
+
+	bUnderwater = bNewUnderwater;
+	if (!bUnderwater && UnderwaterSoundPlayer->IsPlaying())
 	{
-		if (UnderwaterSoundPlayer)
-		{
-			if (UnderwaterSoundPlayer->GetPlayState() == EAudioComponentPlayState::Playing)
-			{
-				UnderwaterSoundPlayer->FadeOut(0.6f, 0.f);
-			}
-		}
+		UnderwaterSoundPlayer->FadeOut(0.6f, 0.f);
 	}
 }
 
 void AShooterCharacter::FKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 0) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 0) return;
 	
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 0);
 }
 
 void AShooterCharacter::OneKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 1) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 1) return;
 
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 1);
 }
 
 void AShooterCharacter::TwoKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 2) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 2) return;
 
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 2);
 }
 
 void AShooterCharacter::ThreeKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 3) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 3) return;
 
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 3);
 }
 
 void AShooterCharacter::FourKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 4) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 4) return;
 
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 4);
 }
 
 void AShooterCharacter::FiveKeyPressed()
 {
-	if (EquippedWeapon->GetSlotIndex() == 5) return;
+	if (EquippedWeapon == nullptr || EquippedWeapon->GetSlotIndex() == 5) return;
 
 	ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), 5);
 }
 
 void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex)
 {
-	if (CurrentItemIndex == NewItemIndex || !Inventory.IsValidIndex(NewItemIndex)) return;
+	if (CurrentItemIndex == NewItemIndex || !IsInventorySlotOccupied(NewItemIndex) || EquippedWeapon == nullptr) return;
 
-	if (CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping)
+	if (Hot.CombatState == ECombatState::ECS_Unoccupied || Hot.CombatState == ECombatState::ECS_Equipping)
 	{
-		CombatState = ECombatState::ECS_Equipping;
+		SetCombatState(ECombatState::ECS_Equipping);
 
-		EquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
-		EquipWeapon(Cast<AWeapon>(Inventory[NewItemIndex]));
+		// Park the equipped weapon in its slot's record, then rebuild the actor from the new slot.
+		SetInventorySlot(CurrentItemIndex, EquippedWeapon->MakeInstanceRecord());
+		EquipInventorySlot(NewItemIndex);
 
 		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 		if (AnimInstance && EquipMontage)
@@ -953,47 +1315,186 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 	}
 }
 
-int32 AShooterCharacter::GetEmptyInventorySlot()
+int32 AShooterCharacter::GetEmptyInventorySlot() const
 {
-	int i{ 0 };
-	for (const auto& Item : Inventory)
+	static_assert(INVENTORY_CAPACITY <= 32, "OccupiedInventorySlots holds a bit per slot.");
+
+	const uint32 FreeSlots{ ~OccupiedInventorySlots & ((1u << INVENTORY_CAPACITY) - 1) };
+	if (FreeSlots == 0) return -1; // Inventory is full.
+
+	return static_cast<int32>(FMath::CountTrailingZeros(FreeSlots));
+}
+
+void AShooterCharacter::SetInventorySlot(int32 SlotIndex, const FWeaponInstanceRecord& Record)
+{
+	if (!Inventory.IsValidIndex(SlotIndex)) return;
+
+	Inventory[SlotIndex] = Record;
+	if (HUDModel && UShooterHUDModel::IsEnabled())
 	{
-		if (Inventory[i] == nullptr)
-		{
-			return i;
-		}
-		++i;
+		HUDModel->MarkInventorySlotChanged(SlotIndex);
+	}
+	if (Record.IsSet())
+	{
+		OccupiedInventorySlots |= 1u << SlotIndex;
 	}
-	if (Inventory.Num() < INVENTORY_CAPACITY)
+	else
 	{
-		return Inventory.Num();
+		OccupiedInventorySlots &= ~(1u << SlotIndex);
 	}
-	return -1; // Inventory is full.
+}
+
+bool AShooterCharacter::IsInventorySlotOccupied(int32 SlotIndex) const
+{
+	return SlotIndex >= 0 && SlotIndex < INVENTORY_CAPACITY && (OccupiedInventorySlots & (1u << SlotIndex)) != 0;
+}
+
+UTexture2D* AShooterCharacter::GetInventorySlotIcon(int32 SlotIndex) const
+{
+	if (!IsInventorySlotOccupied(SlotIndex)) return nullptr;
+	if (EquippedWeapon && EquippedWeapon->GetSlotIndex() == SlotIndex) return EquippedWeapon->GetIconImage();
+
+	const FWeaponDataTable* WeaponData{ AWeapon::FindWeaponData(Inventory[SlotIndex].WeaponType) };
+	return WeaponData ? WeaponData->InventoryIcon : nullptr;
 }
 
 void AShooterCharacter::BeginHighlightInventorySlot()
 {
 	const int32 EmptySlot{ GetEmptyInventorySlot() };
-	HighlightIconDelegate.Broadcast(EmptySlot, true);
+	if (UShooterHUDModel* Model = GetActiveHUDModel())
+	{
+		Model->SetHighlightedSlot(EmptySlot);
+	}
+	else
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HUDWidgetUpdates);
+		HighlightIconDelegate.Broadcast(EmptySlot, true);
+	}
 	HighlightedSlot = EmptySlot;
 }
 
 void AShooterCharacter::EndHighlightInventorySlot()
 {
-	HighlightIconDelegate.Broadcast(HighlightedSlot, false);
+	if (UShooterHUDModel* Model = GetActiveHUDModel())
+	{
+		Model->SetHighlightedSlot(-1);
+	}
+	else
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HUDWidgetUpdates);
+		HighlightIconDelegate.Broadcast(HighlightedSlot, false);
+	}
 	HighlightedSlot = -1;
 }
 
-// Called every frame.  To optimize, some of these could be called on timers from Begin Play.
+UShooterHUDModel* AShooterCharacter::GetActiveHUDModel()
+{
+	if (!UShooterHUDModel::IsEnabled()) return nullptr;
+
+	if (HUDModel == nullptr && IsLocallyControlled())
+	{
+		HUDModel = NewObject<UShooterHUDModel>(this, TEXT("HUDModel"));
+
+		// Start from the current state, so widgets can fill themselves from GetState() when they bind.
+		HUDModel->SetCombatState(Hot.CombatState);
+		HUDModel->SetEquippedSlot(EquippedWeapon ? EquippedWeapon->GetSlotIndex() : -1);
+		HUDModel->SetHighlightedSlot(HighlightedSlot);
+		for (int32 SlotIndex = 0; SlotIndex < INVENTORY_CAPACITY; ++SlotIndex)
+		{
+			HUDModel->MarkInventorySlotChanged(SlotIndex);
+		}
+		UpdateHUDAmmo();
+	}
+	return HUDModel;
+}
+
+void AShooterCharacter::UpdateHUDAmmo()
+{
+	if (HUDModel == nullptr || !UShooterHUDModel::IsEnabled()) return;
+
+	if (EquippedWeapon)
+	{
+		HUDModel->SetMagazineAmmo(EquippedWeapon->GetAmmo(), EquippedWeapon->GetMagazineCapacity());
+	}
+	for (int32 Index = 0; Index < FAmmoLedger::Num(); ++Index)
+	{
+		const EAmmoType AmmoType{ static_cast<EAmmoType>(Index) };
+		HUDModel->SetCarriedAmmo(AmmoType, AmmoLedger.Get(AmmoType));
+	}
+}
+
+void AShooterCharacter::NotifyEquippedSlot(int32 PreviousSlotIndex, int32 NewSlotIndex)
+{
+	if (UShooterHUDModel* Model = GetActiveHUDModel())
+	{
+		Model->SetEquippedSlot(NewSlotIndex);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HUDWidgetUpdates);
+	EquipItemDelegate.Broadcast(PreviousSlotIndex, NewSlotIndex);
+}
+
+void AShooterCharacter::ForwardHUDChanges(const FHUDModelChangeSet& Changes)
+{
+	if (Changes.HasChanged(EHUDModelField::EHF_MagazineAmmo))
+	{
+		if (UFireLatencySubsystem* Latency = UFireLatencySubsystem::Get(this))
+		{
+			Latency->Record(EFireLatencyStage::ShotToHUD, FireLatencyMarks.HUDPending);
+		}
+		FireLatencyMarks.HUDPending = 0.0;
+	}
+	if (Changes.HasChanged(EHUDModelField::EHF_EquippedSlot))
+	{
+		EquipItemDelegate.Broadcast(Changes.PreviousEquippedSlot, Changes.EquippedSlot);
+	}
+	if (Changes.HasChanged(EHUDModelField::EHF_HighlightedSlot))
+	{
+		if (Changes.PreviousHighlightedSlot != -1)
+		{
+			HighlightIconDelegate.Broadcast(Changes.PreviousHighlightedSlot, false);
+		}
+		if (Changes.HighlightedSlot != -1)
+		{
+			HighlightIconDelegate.Broadcast(Changes.HighlightedSlot, true);
+		}
+	}
+}
+
+void AShooterCharacter::SetCombatState(ECombatState State)
+{
+	const bool bWasOccupied{ Hot.CombatState != ECombatState::ECS_Unoccupied };
+	const bool bCouldShareAnimation{ UShooterSignificanceSubsystem::CanShareAnimation(this) };
+	Hot.CombatState = State;
+	if (bWasOccupied != (State != ECombatState::ECS_Unoccupied)
+		|| bCouldShareAnimation != UShooterSignificanceSubsystem::CanShareAnimation(this))
+	{
+		// Firing and reloading protect the mesh from the animation budget now, not at the next significance update, and
+		// firing or equipping takes the mesh off shared crowd animation.
+		if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+		{
+			Significance->RefreshAnimationBudget(this);
+		}
+	}
+	if (HUDModel && UShooterHUDModel::IsEnabled())
+	{
+		HUDModel->SetCombatState(State);
+	}
+}
+
+// Called every frame while an interpolator is awake, see WakeInterpolator().
 void AShooterCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	SetCameraFOV(DeltaTime);
-	SetTurnLookRate();
-	CalculateCrosshairSpread(DeltaTime);
-	TraceForItems();
-	InterpCapsuleHalfHeight(DeltaTime);
-	SetUnderwater();
+	TickInterpolators(DeltaTime, GetTickedInterpolators());
+
+	// Nothing left to settle: sleep until the next wake, unless a Blueprint still wants Tick.
+	if (GetTickedInterpolators() == EShooterInterpolator::None
+		&& !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AShooterCharacter, ReceiveTick)))
+	{
+		SetActorTickEnabled(false);
+	}
 }
 
 // Called to bind functionality to input
@@ -1009,7 +1510,7 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	PlayerInputComponent->BindAxis("Turn", this, &AShooterCharacter::Turn);  // For mouse
 	PlayerInputComponent->BindAxis("LookUp", this, &AShooterCharacter::LookUp); // For mouse
 
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &AShooterCharacter::Jump);
 	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
 
 	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &AShooterCharacter::FireButtonPressed);
@@ -1036,21 +1537,42 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 
 float AShooterCharacter::GetCrosshairSpreadMultiplier() const
 {
-	return CrosshairSpreadMultiplier;
+	return Hot.CrosshairSpreadMultiplier;
+}
+
+UShooterCharacterMovementComponent* AShooterCharacter::GetShooterCharacterMovement() const
+{
+	return CastChecked<UShooterCharacterMovementComponent>(GetCharacterMovement());
 }
 
 void AShooterCharacter::UpdateOverlappedItemCount(int8 Amount)
 {
-	if (OverlappedItemCount + Amount <= 0)
+	const bool bWasTracingForItems{ Hot.bShouldTraceForItems };
+	if (Hot.OverlappedItemCount + Amount <= 0)
 	{
-		OverlappedItemCount = 0;
-		bShouldTraceForItems = false;
+		Hot.OverlappedItemCount = 0;
+		Hot.bShouldTraceForItems = false;
 	}
 	else
 	{
-		OverlappedItemCount += Amount;
-		bShouldTraceForItems = true;
+		Hot.OverlappedItemCount += Amount;
+		Hot.bShouldTraceForItems = true;
 	}
+
+	if (Hot.bShouldTraceForItems && !bWasTracingForItems)
+	{
+		GetWorldTimerManager().SetTimer(ItemTargetingTimer, this, &AShooterCharacter::TraceForItems, 1.f / FMath::Max(GetConfig().TargetingRate, 1.f), true, 0.f);
+	}
+	else if (!Hot.bShouldTraceForItems && bWasTracingForItems)
+	{
+		GetWorldTimerManager().ClearTimer(ItemTargetingTimer);
+		TraceForItems();  // Clears the current target.
+	}
+}
+
+int32 AShooterCharacter::GetAmmoSpace(EAmmoType AmmoType) const
+{
+	return AmmoLedger.GetSpace(AmmoType, GetConfig().MaxCarriedAmmo);
 }
 
 FVector AShooterCharacter::GetCameraInterpLocation()
@@ -1059,8 +1581,8 @@ FVector AShooterCharacter::GetCameraInterpLocation()
 	const FVector CameraForward{ FollowCamera->GetForwardVector() };
 
 	// Desired location = CameraLocation + (Fwd * DistA) + Up.
-	return CameraWorldLocation + (CameraForward * CameraInterpDistance) +
-		FVector(0.f, 0.f, CameraInterpElevation);
+	return CameraWorldLocation + (CameraForward * GetConfig().CameraInterpDistance) +
+		FVector(0.f, 0.f, GetConfig().CameraInterpElevation);
 }
 
 void AShooterCharacter::HandlePickupItem(AItem* Item)
@@ -1076,27 +1598,27 @@ void AShooterCharacter::HandlePickupItem(AItem* Item)
 	
 	if (Weapon)
 	{
-		// If the inventory has enough capacity, add the weapon.
-		if (Inventory.Num() < INVENTORY_CAPACITY)
+		// If the inventory has enough capacity, keep a record of the weapon. The actor itself is no longer needed.
+		const int32 EmptySlot{ GetEmptyInventorySlot() };
+		if (EmptySlot != -1)
 		{
-			Weapon->SetSlotIndex(Inventory.Num());  // Set Weapon SlotIndex based on Inventory's current size, before adding it. 
-			Inventory.Add(Weapon);
-			Weapon->SetItemState(EItemState::EIS_PickedUp);
+			SetInventorySlot(EmptySlot, Weapon->MakeInstanceRecord());
+			Weapon->Destroy();
 		}
 		// Otherwise replace the current weapon in the inventory, drop the old weapon, and equip the new weapon.
 		else
 		{
-			if (Inventory.IsValidIndex(EquippedWeapon->GetSlotIndex()))  
+			if (EquippedWeapon && IsInventorySlotOccupied(EquippedWeapon->GetSlotIndex()))
 			{
-				Inventory[EquippedWeapon->GetSlotIndex()] = Weapon;
+				SetInventorySlot(EquippedWeapon->GetSlotIndex(), Weapon->MakeInstanceRecord());
 				Weapon->SetSlotIndex(EquippedWeapon->GetSlotIndex());
 			}
 		
 			DropWeapon();
 			EquipWeapon(Weapon);
-			TraceHitItem = nullptr;  // Ensures the source of this pickup cannot be picked up again.
-			TraceHitItemLastFrame = nullptr;
 		}
+		TraceHitItem = nullptr;  // Ensures the source of this pickup cannot be picked up again.
+		TraceHitItemLastFrame = nullptr;
 	}
 	
 	auto Ammo = Cast<AAmmo>(Item);
@@ -1105,3 +1627,94 @@ void AShooterCharacter::HandlePickupItem(AItem* Item)
 		PickupAmmo(Ammo);
 	}
 }
+
+void AShooterCharacter::CaptureSaveState(FShooterPlayerSaveState& OutState) const
+{
+	OutState.Inventory.SetNum(Inventory.Num());
+	for (int32 SlotIndex = 0; SlotIndex < Inventory.Num(); ++SlotIndex)
+	{
+		// The equipped weapon's record is only brought up to date when switching away from it.
+		const bool bEquipped{ EquippedWeapon && EquippedWeapon->GetSlotIndex() == SlotIndex };
+		const FWeaponInstanceRecord Record{ bEquipped ? EquippedWeapon->MakeInstanceRecord() : Inventory[SlotIndex] };
+		if (!Record.IsSet()) continue;
+
+		FShooterSavedWeapon& Saved{ OutState.Inventory[SlotIndex] };
+		Saved.ClassPath = Record.WeaponClass->GetPathName();
+		Saved.AmmoCount = Record.AmmoCount;
+		Saved.WeaponType = static_cast<uint8>(Record.WeaponType);
+		Saved.Rarity = static_cast<uint8>(Record.Rarity);
+	}
+	OutState.EquippedSlot = EquippedWeapon ? EquippedWeapon->GetSlotIndex() : INDEX_NONE;
+
+	OutState.CarriedAmmo.SetNum(FAmmoLedger::Num());
+	for (int32 Index = 0; Index < FAmmoLedger::Num(); ++Index)
+	{
+		OutState.CarriedAmmo[Index] = AmmoLedger.Get(static_cast<EAmmoType>(Index));
+	}
+}
+
+void AShooterCharacter::RestoreSaveState(const FShooterPlayerSaveState& State)
+{
+	for (int32 SlotIndex = 0; SlotIndex < Inventory.Num(); ++SlotIndex)
+	{
+		FWeaponInstanceRecord Record;
+		if (State.Inventory.IsValidIndex(SlotIndex) && !State.Inventory[SlotIndex].ClassPath.IsEmpty())
+		{
+			const FShooterSavedWeapon& Saved{ State.Inventory[SlotIndex] };
+			Record.WeaponClass = FSoftClassPath(Saved.ClassPath).TryLoadClass<AWeapon>();
+			Record.AmmoCount = Saved.AmmoCount;
+			Record.WeaponType = static_cast<EWeaponType>(Saved.WeaponType);
+			Record.Rarity = static_cast<EItemRarity>(Saved.Rarity);
+		}
+		SetInventorySlot(SlotIndex, Record);
+	}
+
+	for (int32 Index = 0; Index < State.CarriedAmmo.Num() && Index < FAmmoLedger::Num(); ++Index)
+	{
+		AmmoLedger.Set(static_cast<EAmmoType>(Index), State.CarriedAmmo[Index]);
+	}
+
+	// Nothing started before the load may finish after it: the auto-fire timer would fire the loaded weapon, and the
+	// reload and equip montages' notifies would reload or equip it.
+	GetWorldTimerManager().ClearTimer(AutoFireTimer);
+	GetWorldTimerManager().ClearTimer(CrosshairShootTimer);
+	FinishCrosshairBulletFireTimer();
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		// A null montage would stop every montage, so only stop the ones set.
+		for (UAnimMontage* Montage : { ReloadMontage, EquipMontage })
+		{
+			if (Montage)
+			{
+				AnimInstance->Montage_Stop(0.f, Montage);
+			}
+		}
+	}
+	SetCombatState(ECombatState::ECS_Unoccupied);
+
+	// The weapon in hand belongs to the pre-load inventory, whose records were just replaced. Without a saved slot, the
+	// first occupied one is equipped, so the character only goes empty-handed with an empty inventory.
+	int32 SlotToEquip{ State.EquippedSlot };
+	if (!IsInventorySlotOccupied(SlotToEquip))
+	{
+		SlotToEquip = INDEX_NONE;
+		for (int32 SlotIndex = 0; SlotIndex < INVENTORY_CAPACITY && SlotToEquip == INDEX_NONE; ++SlotIndex)
+		{
+			if (IsInventorySlotOccupied(SlotIndex))
+			{
+				SlotToEquip = SlotIndex;
+			}
+		}
+	}
+	if (IsInventorySlotOccupied(SlotToEquip))
+	{
+		EquipInventorySlot(SlotToEquip);
+	}
+	else if (EquippedWeapon)
+	{
+		NotifyEquippedSlot(EquippedWeapon->GetSlotIndex(), INDEX_NONE);
+		EquippedWeapon->Destroy();
+		EquippedWeapon = nullptr;
+	}
+	UpdateHUDAmmo();
+}
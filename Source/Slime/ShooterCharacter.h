@@ -5,6 +5,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "AmmoType.h"
+#include "Weapon.h"
+#include "ShooterRules.h"
+#include "ShooterCharacterConfig.h"
+#include "FireLatencySubsystem.h"
 #include "ShooterCharacter.generated.h"
 
 
@@ -19,6 +23,118 @@ enum class ECombatState : uint8
 	ECS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/** Interpolators Tick() advances. Each is woken when its target changes and sleeps once it has converged. */
+enum class EShooterInterpolator : uint8
+{
+	None = 0,
+	CameraFOV = 1 << 0,
+	CrosshairSpread = 1 << 1,
+	CrouchCameraOffset = 1 << 2,
+
+	All = CameraFOV | CrosshairSpread | CrouchCameraOffset,
+
+	/** Advanced by UCharacterCosmeticsSubsystem for every character at once while slime.Cosmetics.Batched is on. */
+	Cosmetics = CameraFOV | CrosshairSpread
+};
+ENUM_CLASS_FLAGS(EShooterInterpolator);
+
+/**
+ * Crosshair spread targets and interpolation speeds, read by AShooterCharacter::CalculateCrosshairSpread() and by the
+ * batched kernels of UCharacterCosmeticsSubsystem, so both paths spread the crosshairs the same way.
+ */
+namespace ShooterCrosshair
+{
+	/** Spread multiplier standing still on the ground, before any factor is added. */
+	constexpr float BaseSpread{ 0.5f };
+
+	/** Lateral speed at which the velocity factor reaches 1. */
+	constexpr float MaxVelocitySpeed{ 600.f };
+
+	/** Spread crosshairs slowly while in air, return them quickly on the ground. */
+	constexpr float InAirTarget{ 2.25f };
+	constexpr float InAirSpreadSpeed{ 2.25f };
+	constexpr float InAirReturnSpeed{ 30.f };
+
+	/** Tighten crosshairs quickly a small amount while aiming. */
+	constexpr float AimTarget{ -0.4f };
+	constexpr float AimSpeed{ 30.f };
+
+	/** Widen crosshairs very quickly a small amount while a shot is fired, return them quickly. */
+	constexpr float ShootingTarget{ 0.7f };
+	constexpr float ShootingSpreadSpeed{ 60.f };
+	constexpr float ShootingReturnSpeed{ 45.f };
+}
+
+/** Per-frame state of a shooter character. Tuning lives in UShooterCharacterConfig. */
+USTRUCT(BlueprintType)
+struct FShooterCharacterHotState
+{
+	GENERATED_BODY()
+
+	/** Determines spread of cross hairs. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Crosshairs)
+	float CrosshairSpreadMultiplier{ 0.5f };
+
+	/** Velocity, in air, aim and shooting factors of the cross hairs spread. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Crosshairs)
+	float CrosshairVelocityFactor{ 0.f };
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Crosshairs)
+	float CrosshairInAirFactor{ 0.f };
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Crosshairs)
+	float CrosshairAimFactor{ 0.f };
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Crosshairs)
+	float CrosshairShootingFactor{ 0.f };
+
+	/** Field of view this frame, and the camera's own, read in BeginPlay(). */
+	float CameraCurrentFOV{ 0.f };
+	float CameraDefaultFOV{ 0.f };
+
+	/** Base turn and look up/down rates, in deg/sec. Other scaling may affect final turn rate. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Camera)
+	float BaseTurnRate{ 45.f };
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Camera)
+	float BaseLookUpRate{ 45.f };
+
+	/** Height the camera boom is still offset from its resting place after the capsule was resized. */
+	float CrouchCameraOffset{ 0.f };
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Combat)
+	ECombatState CombatState{ ECombatState::ECS_Unoccupied };
+
+	/** Interpolators Tick() still has to advance. Actor tick is disabled while none are, unless a Blueprint implements Tick. */
+	EShooterInterpolator ActiveInterpolators{ EShooterInterpolator::None };
+
+	/** Number of overlapped AItems. */
+	int8 OverlappedItemCount{ 0 };
+
+	/** True when aiming. */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Combat)
+	bool bAiming{ false };
+
+	bool bAimingButtonPressed{ false };
+
+	/** True while a shot spreads the crosshairs. */
+	bool bFiringBullet{ false };
+
+	/** For automatic weapon fire, timer based. */
+	bool bFireButtonPressed{ false };
+	bool bShouldFire{ true };
+
+	/** True if character should trace for items. */
+	bool bShouldTraceForItems{ false };
+};
+
+#if !UE_BUILD_SHIPPING
+/** Results of AShooterCharacter::BenchmarkCrowd(), per character pass. Cache misses are negative where they can't be read. */
+struct FShooterCrowdBenchmark
+{
+	double PerCharacterNanoseconds{ 0.0 };
+	double BatchedNanoseconds{ 0.0 };
+	double PerCharacterCacheMisses{ -1.0 };
+	double BatchedCacheMisses{ -1.0 };
+};
+#endif
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, SlotIndex, bool, bStartAnimation);
 
@@ -29,11 +145,13 @@ class SLIME_API AShooterCharacter : public ACharacter
 
 public:
 	// Sets default values for this character's properties
-	AShooterCharacter();
+	AShooterCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PostLoad() override;
 
 	/** Called for forwards/backwards input */
 	void MoveForward(float Value);
@@ -70,11 +188,20 @@ protected:
 	void AimingButtonPressed();
 	void AimingButtonReleased();
 	
-	void SetCameraFOV(float DeltaTime);
+	/** Returns true once the FOV has reached its target. */
+	bool SetCameraFOV(float DeltaTime);
+	FORCEINLINE float GetTargetFOV() const { return Hot.bAiming ? GetConfig().CameraZoomedFOV : Hot.CameraDefaultFOV; }
+
+	/** Snaps an FOV within tolerance of its target onto it and applies it to the camera. Returns true if it snapped. */
+	bool SettleCameraFOV();
 	void SetTurnLookRate();
 
 	// Crosshairs
-	void CalculateCrosshairSpread(float DeltaTime);
+	/** Returns true once the character is still and every spread factor has reached its target. */
+	bool CalculateCrosshairSpread(float DeltaTime);
+
+	/** Snaps converged spread factors onto their targets and sums them. Returns true if the spread has settled. */
+	bool SettleCrosshairSpread(bool bFalling);
 	void StartCrosshairBulletFireTimer();
 	UFUNCTION()
 	void FinishCrosshairBulletFireTimer();
@@ -89,16 +216,43 @@ protected:
 	void AutoFireReset();
 
 	// Look at items
-	bool TraceUnderCrosshairs(FHitResult& OutHitResult);
 	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
+	/** Targets, highlights and shows the pickup widget for the best item from FindTargetItem(). Runs on ItemTargetingTimer. */
 	void TraceForItems();
 
+	/** Scores nearby ground items by angle to the view and distance, and returns the best if nothing blocks the view of it. */
+	AItem* FindTargetItem() const;
+
+	/** Moves the shared pickup widget to the item and fills it from the item's data. */
+	void ShowPickupWidget(AItem* Item);
+	void HidePickupWidget();
+
+	/** Creates the pickup widget component the first time a locally controlled character needs it. */
+	class UWidgetComponent* GetOrCreatePickupWidget();
+
 	/** Spawns default weapon and attaches to mesh. */
 	class AWeapon* SpawnDefaultWeapon();
 
 	/** Takes a Weapon and attaches to mesh. */
 	void EquipWeapon(AWeapon* WeaponToEquip);
 
+	/** Makes the equipped weapon the one recorded in the slot, re-skinning the current actor when the class matches. */
+	void EquipInventorySlot(int32 SlotIndex);
+
+	/** Spawns a weapon actor from an inventory record, e.g. when the equipped weapon's class has to change. */
+	AWeapon* SpawnWeaponFromRecord(const FWeaponInstanceRecord& Record);
+
+	/** The HUD model, or null if slime.HUD.UseModel is off or this character isn't locally controlled. */
+	class UShooterHUDModel* GetActiveHUDModel();
+
+	/** Pushes magazine and carried ammo to the HUD model. */
+	void UpdateHUDAmmo();
+
+	/** Tells the HUD the equipped slot changed, through the HUD model or EquipItemDelegate. */
+	void NotifyEquippedSlot(int32 PreviousSlotIndex, int32 NewSlotIndex);
+
+	void SetCombatState(ECombatState State);
+
 	/** Currently equipped weapon. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	AWeapon* EquippedWeapon;
@@ -116,8 +270,8 @@ protected:
 	/** Drops currently equipped weapon and equips weapon hit by trace. */
 	void SwapWeapon(AWeapon* WeaponToSwap);
 
-	/** Initialize Ammo Map with ammo values.  */
-	void InitializeAmmoMap();
+	/** Fills the ammo ledger with the starting ammo. */
+	void InitializeAmmoLedger();
 	bool WeaponHasAmmo();
 
 	void ReloadWeapon();
@@ -151,8 +305,29 @@ protected:
 	
 	void CrouchButtonPressed();
 
-	/** Interps capsule half height when changing from standing to crouching. */
-	void InterpCapsuleHalfHeight(float DeltaTime);
+	/** Stands up instead of jumping while crouched. */
+	virtual void Jump() override;
+
+	/**
+	 * The movement component resizes the capsule in one step, which would drop or raise the camera with it. The camera
+	 * boom is offset to cancel the step, and the offset eased back to zero by InterpCrouchCameraOffset().
+	 */
+	virtual void OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust) override;
+	virtual void OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust) override;
+
+	/** Eases the camera boom to its resting place after a crouch or uncrouch. Returns true once it is there. */
+	bool InterpCrouchCameraOffset(float DeltaTime);
+
+	/** Has Tick() advance Interpolator until it converges. */
+	void WakeInterpolator(EShooterInterpolator Interpolator);
+
+	/** Advances the awake ones of Interpolators and puts the converged ones to sleep. */
+	void TickInterpolators(float DeltaTime, EShooterInterpolator Interpolators);
+
+	/** Awake interpolators Tick() has to advance itself: all of them, less those the cosmetics subsystem batches. */
+	EShooterInterpolator GetTickedInterpolators() const;
+
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
 	void Aim();
 
@@ -160,11 +335,20 @@ protected:
 
 	void PickupAmmo(class AAmmo* Ammo);
 
+	/**
+	 * Surface under the character, from the floor the movement component last found. A short trace reads it only
+	 * when the floor component or face changes; other footsteps reuse the cached surface.
+	 */
 	UFUNCTION(BlueprintCallable)
 	EPhysicalSurface GetFootstepSurface();
 
-	void SetUnderwater();
-	void SetUnderwaterSFX();
+	/** Bound to the capsule's physics volume changes, to start or stop checking for the water surface. */
+	UFUNCTION()
+	void OnPhysicsVolumeChanged(class APhysicsVolume* NewVolume);
+
+	/** Compares the camera against the surface of the water volume the character is in. */
+	void UpdateUnderwater();
+	void SetUnderwater(bool bNewUnderwater);
 
 	void FKeyPressed();
 	void OneKeyPressed();
@@ -173,7 +357,9 @@ protected:
 	void FourKeyPressed();
 	void FiveKeyPressed();
 	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
-	int32 GetEmptyInventorySlot();
+	/** Lowest free inventory slot, or -1 if the inventory is full. */
+	int32 GetEmptyInventorySlot() const;
+	void SetInventorySlot(int32 SlotIndex, const FWeaponInstanceRecord& Record);
 	void BeginHighlightInventorySlot();
 	
 	
@@ -187,6 +373,17 @@ public:
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
 private:
+	/**
+	 * State read or written every frame, kept together so a tick touches one or two cache lines of this character
+	 * instead of a field here and there across the whole object.
+	 */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = State, meta = (AllowPrivateAccess = "true"))
+	FShooterCharacterHotState Hot;
+
+	/** Tuning shared by every character of this class. When unset, UShooterCharacterConfig's defaults are used. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Config, meta = (AllowPrivateAccess = "true"))
+	UShooterCharacterConfig* Config;
+
 	/** Camera boom positioning the camera behind the character. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class USpringArmComponent* CameraBoom;
@@ -195,48 +392,8 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
 
-	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float BaseTurnRate;
-
-	/** Base look up/down rate, in deg/sec. Other scaling may affect final turn rate. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float BaseLookUpRate;
-
-	/** Turn rate while NOT aiming. Console controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float HipTurnRate;
-
-	/** Look up/down rate while NOT aiming. Console controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float HipLookUpRate;
-
-	/** Turn rate while aiming. Console controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float AimingTurnRate;
-	
-	/** Look up/down rate while aiming. Console controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	float AimingLookUpRate;
-
-	/** Turn rate while NOT aiming. Mouse controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
-	float MouseHipTurnRate;
-
 // Private: Continued.
 
-	/** Look up/down rate while aiming. Mouse controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
-	float MouseHipLookUpRate;
-
-	/** Turn rate while aiming. Mouse controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
-	float MouseAimingTurnRate;
-
-	/** Look up/down rate while aiming. Mouse controller only. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
-	float MouseAimingLookUpRate;
-
 	/** Gunshot sound cue */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	class USoundCue* FireSound;
@@ -257,102 +414,53 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* BeamParticles;
 
-	/** True when aiming. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	bool bAiming;
-
 	/** Underwater sound cue */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USoundCue* UnderwaterSoundCue;
 
+	/** Plays UnderwaterSoundCue while the camera is under water. Created once, and restarted as needed. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UAudioComponent* UnderwaterSoundPlayer;
 
-	
 // Private: Continued.
 
-	/** Default camera field of view. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float CameraDefaultFOV;
-
-	/** Field of view when zoomed in. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float CameraZoomedFOV;
-
-	/** Used for camera interpolation: field of view this frame. */
-	float CameraCurrentFOV;
-
-	/** Speed to change camera from Default to Zoomed. Higher is faster. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float ZoomInterpSpeed;
-
-	/** Determines spread of cross hairs. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
-	float CrosshairSpreadMultiplier;
-
-	/** Velocity factor for cross hairs spread. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
-	float CrosshairVelocityFactor;
-
-	/** In air factor for cross hairs spread. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
-	float CrosshairInAirFactor;
-
-	/** Aim factor for cross hairs spread. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
-	float CrosshairAimFactor;
-
-	/** Shooting factor for cross hairs spread. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
-	float CrosshairShootingFactor;
-	float ShootTimeDuration;
-	bool bFiringBullet;
+	/** Ends the crosshair spread of a shot, see StartCrosshairBulletFireTimer(). */
 	FTimerHandle CrosshairShootTimer;
 
-// Private: Continued.
-	
 	/** For automatic weapon fire, timer based. */
-	bool bFireButtonPressed;
-	bool bShouldFire;
-	float AutomaticFireRate;
 	FTimerHandle AutoFireTimer;
 
-	/** True if character should trace for items. */
-	bool bShouldTraceForItems;
+	/** Timestamps of the shot in flight, for UFireLatencySubsystem. */
+	FFireLatencyMarks FireLatencyMarks;
 
-	/** Number of overlapped AItems. */
-	int8 OverlappedItemCount;
+	/** Runs TraceForItems() while bShouldTraceForItems is set. */
+	FTimerHandle ItemTargetingTimer;
 
 	/** The AItem we hit last frame. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	class AItem* TraceHitItemLastFrame;
 
-	/** AItem hit by trace in TraceForItems() - could be null. */
+	/** AItem targeted in TraceForItems() - could be null. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItem;
 
-	/** Distance outward from the camera for an interpolation destination, from item world location to in front of viewer. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float CameraInterpDistance;
+	/** Widget shown above the traced item. Created once per local player, see GetOrCreatePickupWidget(). */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class UPickupWidget> PickupWidgetClass;
 
-	/** Distance upward from the camera for an interpolation destination, from item world location to in front of viewer. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float CameraInterpElevation;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = Items, meta = (AllowPrivateAccess = "true"))
+	UWidgetComponent* PickupWidget;
 
-	/** Map to track different ammo types. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	TMap<EAmmoType, int32> AmmoMap;
+	/** Item the pickup widget is currently filled from. */
+	UPROPERTY(Transient)
+	AItem* PickupWidgetItem;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-	int32 Starting9mmAmmo;
-	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-	int32 StartingARAmmo;
+	typedef ShooterRules::TAmmoLedger<EAmmoType, static_cast<int32>(EAmmoType::EAT_MAX)> FAmmoLedger;
+
+	/** Carried ammo of each type. */
+	FAmmoLedger AmmoLedger;
 
 // Private continued.
-	
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	ECombatState CombatState;
 
 	/** Montage for reloading the weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -361,46 +469,39 @@ private:
 	/** Montage for equipping the weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* EquipMontage;
-	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	bool bCrouching;
-
-	/** Regular movement speed, based on initial Character Movement Component Max Walk Speed. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float BaseMovementSpeed;
-
-	/** Crouch walking movement speed. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float CrouchMovementSpeed;
-
-	/** Aim walking movement speed. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float AimMovementSpeed;
-
-	/** Current Half Height of the Collision Capsule. */
-	float CurrentCapsuleHalfHeight;
 
-	/** Half height of capsule when not crouching. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float StandingCapsuleHalfHeight;
-
-	/** Half height of capsule when crouching. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float CrouchingCapsuleHalfHeight;
-
-	bool bAimingButtonPressed;
+	/** Camera boom's relative location when the character isn't crouching or uncrouching. */
+	FVector CameraBoomBaseLocation;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	bool bUnderwater;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	float SetUnderwaterTimerRate;
 	FTimerHandle CheckUnderwaterTimer;
 
+	/** Footstep sound of each surface, played by PlayFootstep(). */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	class UFootstepBank* FootstepBank;
+
+	/** Floor component and face FootstepSurface was traced for. */
+	TWeakObjectPtr<const UPrimitiveComponent> FootstepFloorComponent;
+	int32 FootstepFloorFaceIndex;
+	EPhysicalSurface FootstepSurface;
+
+	/** The water volume the capsule is in, if any. */
+	UPROPERTY(Transient)
+	class AShooterWaterVolume* WaterVolume;
+
+	/**
+	 * Carried weapons by slot, INVENTORY_CAPACITY long. Only the equipped weapon is an actor; its record is brought
+	 * up to date when switching away from it, so read EquippedWeapon for its live ammo.
+	 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
-	TArray<AItem*> Inventory;
+	TArray<FWeaponInstanceRecord> Inventory;
 
-	const int32 INVENTORY_CAPACITY{ 6 };
+	/** Bit per occupied inventory slot, so finding a free slot is a single bit scan. */
+	uint32 OccupiedInventorySlots;
+
+	static constexpr int32 INVENTORY_CAPACITY{ 6 };
 
 	/** Delegate for sending slot info to InventoryBar widget when equipping weapons. */
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
@@ -410,24 +511,161 @@ private:
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
 	FHighlightIconDelegate HighlightIconDelegate;
 
+	/** View-model the HUD widgets bind to, created on first use by a locally controlled character. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = HUD, meta = (AllowPrivateAccess = "true"))
+	UShooterHUDModel* HUDModel;
+
 	/** Inventory index of currently highlighted slot, where -1 is None, 0 is Default Weapon, 1 is Slot 1, 2 is Slot 2, etc. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	int32 HighlightedSlot;
-	
+
+#if WITH_EDITORONLY_DATA
+	/** Tuning saved on characters from before UShooterCharacterConfig. PostLoad() moves overrides into a config. */
+	UPROPERTY()
+	float HipTurnRate_DEPRECATED;
+	UPROPERTY()
+	float HipLookUpRate_DEPRECATED;
+	UPROPERTY()
+	float AimingTurnRate_DEPRECATED;
+	UPROPERTY()
+	float AimingLookUpRate_DEPRECATED;
+	UPROPERTY()
+	float MouseHipTurnRate_DEPRECATED;
+	UPROPERTY()
+	float MouseHipLookUpRate_DEPRECATED;
+	UPROPERTY()
+	float MouseAimingTurnRate_DEPRECATED;
+	UPROPERTY()
+	float MouseAimingLookUpRate_DEPRECATED;
+	UPROPERTY()
+	float CameraZoomedFOV_DEPRECATED;
+	UPROPERTY()
+	float ZoomInterpSpeed_DEPRECATED;
+	UPROPERTY()
+	float TargetingRate_DEPRECATED;
+	UPROPERTY()
+	float TargetingRadius_DEPRECATED;
+	UPROPERTY()
+	float TargetingConeAngle_DEPRECATED;
+	UPROPERTY()
+	float TargetingDistanceWeight_DEPRECATED;
+	UPROPERTY()
+	float CameraInterpDistance_DEPRECATED;
+	UPROPERTY()
+	float CameraInterpElevation_DEPRECATED;
+	UPROPERTY()
+	int32 Starting9mmAmmo_DEPRECATED;
+	UPROPERTY()
+	int32 StartingARAmmo_DEPRECATED;
+	UPROPERTY()
+	int32 MaxCarriedAmmo_DEPRECATED;
+	UPROPERTY()
+	float CrouchMovementSpeed_DEPRECATED;
+	UPROPERTY()
+	float AimMovementSpeed_DEPRECATED;
+	UPROPERTY()
+	float CrouchingCapsuleHalfHeight_DEPRECATED;
+	UPROPERTY()
+	float SetUnderwaterTimerRate_DEPRECATED;
+	UPROPERTY()
+	float UnderwaterCameraDepth_DEPRECATED;
+
+	/** Moves the deprecated tuning this character overrides into its own config. */
+	void MigrateConfig();
+#endif
+
 	// End Private Section.
 	
 public:
 	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
-	FORCEINLINE bool GetAiming() const { return bAiming ; }
+	UFUNCTION(BlueprintPure, Category = Combat)
+	bool GetAiming() const { return Hot.bAiming; }
 	UFUNCTION(BlueprintCallable)
 	float GetCrosshairSpreadMultiplier() const;
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
+
+	/** Velocity, in air, aim and shooting factors of the cross hairs spread. */
+	UFUNCTION(BlueprintPure, Category = Crosshairs)
+	float GetCrosshairVelocityFactor() const { return Hot.CrosshairVelocityFactor; }
+	UFUNCTION(BlueprintPure, Category = Crosshairs)
+	float GetCrosshairInAirFactor() const { return Hot.CrosshairInAirFactor; }
+	UFUNCTION(BlueprintPure, Category = Crosshairs)
+	float GetCrosshairAimFactor() const { return Hot.CrosshairAimFactor; }
+	UFUNCTION(BlueprintPure, Category = Crosshairs)
+	float GetCrosshairShootingFactor() const { return Hot.CrosshairShootingFactor; }
+
+	/** Base turn and look up/down rates, in deg/sec. */
+	UFUNCTION(BlueprintPure, Category = Camera)
+	float GetBaseTurnRate() const { return Hot.BaseTurnRate; }
+	UFUNCTION(BlueprintPure, Category = Camera)
+	float GetBaseLookUpRate() const { return Hot.BaseLookUpRate; }
+
+	FORCEINLINE int8 GetOverlappedItemCount() const { return Hot.OverlappedItemCount; }
 	/** Adds to or subtracts from OverlappedItemCount and updates bShouldTraceForItems. */
 	void UpdateOverlappedItemCount(int8 Amount);
 	FVector GetCameraInterpLocation();
 	void HandlePickupItem(AItem* Item);
-	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
-	FORCEINLINE bool GetCrouching() const { return bCrouching; }
+	UFUNCTION(BlueprintPure, Category = Combat)
+	ECombatState GetCombatState() const { return Hot.CombatState; }
+	FORCEINLINE bool GetCrouching() const { return bIsCrouched; }
+	class UShooterCharacterMovementComponent* GetShooterCharacterMovement() const;
 	void EndHighlightInventorySlot();
+	/** How much more ammo of this type the character can carry. */
+	int32 GetAmmoSpace(EAmmoType AmmoType) const;
+
+	UFUNCTION(BlueprintPure, Category = Items)
+	int32 GetCarriedAmmo(EAmmoType AmmoType) const { return AmmoLedger.Get(AmmoType); }
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool IsInventorySlotOccupied(int32 SlotIndex) const;
+
+	/** Inventory bar icon of the weapon in the slot, or null if the slot is empty. */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	UTexture2D* GetInventorySlotIcon(int32 SlotIndex) const;
+
+	/** The HUD model for widgets to bind to. Null when slime.HUD.UseModel is off. */
+	UFUNCTION(BlueprintCallable, Category = HUD)
+	UShooterHUDModel* GetHUDModel() { return GetActiveHUDModel(); }
+
+	/** Replays a published change set through EquipItemDelegate and HighlightIconDelegate, for widgets still bound to them. */
+	void ForwardHUDChanges(const struct FHUDModelChangeSet& Changes);
+
+	/** Plays the footstep sound of the surface underfoot at Location. Called by UAnimNotify_Footstep. */
+	void PlayFootstep(const FVector& Location, float VolumeMultiplier = 1.f);
+
+#if !UE_BUILD_SHIPPING
+	/**
+	 * Times Iterations interpolator passes of an idle character, with every interpolator asleep, and of one that runs all of
+	 * them as Tick() used to. Used by slime.Character.BenchmarkTick.
+	 */
+	void BenchmarkInterpolators(int32 Iterations, double& OutIdleNanoseconds, double& OutActiveNanoseconds);
+
+	/**
+	 * Runs Passes rounds of every interpolator over Characters, one character after another, so each pass reaches
+	 * each character's state from cold: once each character on its own, and once with crosshair spread and FOV
+	 * batched by UCharacterCosmeticsSubsystem. Outputs time and last level cache misses per character pass. Used by
+	 * slime.Character.BenchmarkCrowd.
+	 */
+	static FShooterCrowdBenchmark BenchmarkCrowd(const TArray<AShooterCharacter*>& Characters, int32 Passes);
+#endif
+
+	FORCEINLINE EShooterInterpolator GetActiveInterpolators() const { return Hot.ActiveInterpolators; }
+
+	/** Copies this character's crosshair spread and FOV inputs into Batch at Index. */
+	void GatherCosmetics(struct FCharacterCosmeticsBatch& Batch, int32 Index) const;
+
+	/** Takes back the interpolated values at Index, and sleeps the interpolators that settled. */
+	void ScatterCosmetics(const FCharacterCosmeticsBatch& Batch, int32 Index);
+
+	/** Called when slime.Cosmetics.Batched changes, so Tick() takes back the awake interpolators the batch no longer runs. */
+	void OnCosmeticsBatchingChanged();
+
+	/** Tuning of this character's class. */
+	FORCEINLINE const UShooterCharacterConfig& GetConfig() const { return Config ? *Config : *GetDefault<UShooterCharacterConfig>(); }
+
+	/** Copies the inventory, equipped slot and carried ammo for a save. */
+	void CaptureSaveState(struct FShooterPlayerSaveState& OutState) const;
+
+	/** Replaces the inventory and carried ammo with saved ones, and equips the saved slot. */
+	void RestoreSaveState(const FShooterPlayerSaveState& State);
 };
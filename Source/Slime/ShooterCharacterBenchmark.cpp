@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCharacter.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "CharacterCosmeticsSubsystem.h"
+#include "Slime.h"
+#include "EngineUtils.h"
+
+#if PLATFORM_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	/**
+	 * Counts the last level cache misses of the calling thread, in user mode, from the CPU's hardware counter. Only Linux
+	 * lets a process read it without a profiler attached; elsewhere, and where perf_event_paranoid forbids it, IsValid()
+	 * is false and the benchmark has to run under VTune or a similar profiler instead. Work other threads do, such as
+	 * the cosmetics kernels of a large batch, isn't counted.
+	 */
+	class FCacheMissCounter
+	{
+	public:
+		FCacheMissCounter()
+		{
+#if PLATFORM_LINUX
+			perf_event_attr Attributes;
+			FMemory::Memzero(Attributes);
+			Attributes.type = PERF_TYPE_HARDWARE;
+			Attributes.size = sizeof(Attributes);
+			Attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+			Attributes.disabled = 1;
+			Attributes.exclude_kernel = 1;
+			Attributes.exclude_hv = 1;
+			FileDescriptor = static_cast<int32>(syscall(__NR_perf_event_open, &Attributes, 0, -1, -1, 0));
+#endif
+		}
+
+		~FCacheMissCounter()
+		{
+#if PLATFORM_LINUX
+			if (IsValid())
+			{
+				close(FileDescriptor);
+			}
+#endif
+		}
+
+		bool IsValid() const { return FileDescriptor >= 0; }
+
+		void Start()
+		{
+#if PLATFORM_LINUX
+			if (IsValid())
+			{
+				ioctl(FileDescriptor, PERF_EVENT_IOC_RESET, 0);
+				ioctl(FileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		/** Misses since Start(), or -1 if they can't be read. */
+		double Stop()
+		{
+#if PLATFORM_LINUX
+			uint64 Count{ 0 };
+			if (IsValid())
+			{
+				ioctl(FileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+				if (read(FileDescriptor, &Count, sizeof(Count)) == sizeof(Count))
+				{
+					return static_cast<double>(Count);
+				}
+			}
+#endif
+			return -1.0;
+		}
+
+	private:
+		int32 FileDescriptor{ -1 };
+	};
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkTickCommand(
+	TEXT("slime.Character.BenchmarkTick"),
+	TEXT("Times the interpolator pass of each shooter character idle, and running every interpolator as Tick() used to. Optional argument: iterations (default 10000)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations{ FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000, 1) };
+		for (TActorIterator<AShooterCharacter> It(World); It; ++It)
+		{
+			double IdleNanoseconds{ 0.0 };
+			double ActiveNanoseconds{ 0.0 };
+			It->BenchmarkInterpolators(Iterations, IdleNanoseconds, ActiveNanoseconds);
+			UE_LOG(LogSlime, Display, TEXT("%s, %d iterations: idle %.2f ns, all interpolators %.2f ns"),
+				*It->GetName(), Iterations, IdleNanoseconds, ActiveNanoseconds);
+		}
+	}));
+
+/**
+ * Cache misses are read from the hardware counter on Linux, see FCacheMissCounter. Elsewhere, run this under a profiler
+ * (VTune, or AMD uProf) and compare builds; the time per character pass follows the misses closely enough for a quick check.
+ */
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkCrowdCommand(
+	TEXT("slime.Character.BenchmarkCrowd"),
+	TEXT("Spawns copies of the first shooter character until there are Count (default 200), runs Passes (default 100) interpolator passes over all of them, then destroys the copies."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count{ FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200, 1) };
+		const int32 Passes{ FMath::Max(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 100, 1) };
+
+		TActorIterator<AShooterCharacter> It(World);
+		if (!It) return;
+
+		AShooterCharacter* Template{ *It };
+		TArray<AShooterCharacter*> Characters{ Template };
+		TArray<AShooterCharacter*> Spawned;
+		for (int32 Index = 1; Index < Count; ++Index)
+		{
+			// A grid behind the template, so the copies don't stand in each other's capsules.
+			const FVector Offset{ -200.f * (1 + Index / 16), 200.f * (Index % 16 - 8), 0.f };
+			const FTransform SpawnTransform{ Template->GetActorRotation(), Template->GetActorLocation() + Offset };
+			AShooterCharacter* Character = World->SpawnActorDeferred<AShooterCharacter>(
+				Template->GetClass(),
+				SpawnTransform,
+				nullptr,
+				nullptr,
+				ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (Character == nullptr) continue;
+
+			Character->FinishSpawning(SpawnTransform);
+			Characters.Add(Character);
+			Spawned.Add(Character);
+		}
+
+		const FShooterCrowdBenchmark Result{ AShooterCharacter::BenchmarkCrowd(Characters, Passes) };
+		UE_LOG(LogSlime, Display, TEXT("%d characters, %d passes: %.2f ns per character pass, %.2f ns batched, hot state %d bytes"),
+			Characters.Num(), Passes, Result.PerCharacterNanoseconds, Result.BatchedNanoseconds, static_cast<int32>(sizeof(FShooterCharacterHotState)));
+		if (Result.PerCharacterCacheMisses >= 0.0)
+		{
+			UE_LOG(LogSlime, Display, TEXT("Last level cache misses per character pass: %.2f, %.2f batched"),
+				Result.PerCharacterCacheMisses, Result.BatchedCacheMisses);
+		}
+		else
+		{
+			UE_LOG(LogSlime, Display, TEXT("Cache misses can't be read on this platform; run the benchmark under a profiler to count them."));
+		}
+
+		// The copies' default weapons go with them.
+		TArray<AActor*> AttachedActors;
+		for (AShooterCharacter* Character : Spawned)
+		{
+			Character->GetAttachedActors(AttachedActors);
+			for (AActor* Attached : AttachedActors)
+			{
+				Attached->Destroy();
+			}
+			Character->Destroy();
+		}
+	}));
+
+void AShooterCharacter::BenchmarkInterpolators(int32 Iterations, double& OutIdleNanoseconds, double& OutActiveNanoseconds)
+{
+	const EShooterInterpolator SavedInterpolators{ Hot.ActiveInterpolators };
+	const float DeltaTime{ 1.f / 60.f };
+
+	Hot.ActiveInterpolators = EShooterInterpolator::None;
+	double StartTime{ FPlatformTime::Seconds() };
+	for (int32 Index = 0; Index < Iterations; ++Index)
+	{
+		TickInterpolators(DeltaTime, EShooterInterpolator::All);
+	}
+	OutIdleNanoseconds = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / Iterations;
+
+	// Every interpolator, every pass, as Tick() ran them before they could sleep. At their targets they stay put.
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < Iterations; ++Index)
+	{
+		Hot.ActiveInterpolators = EShooterInterpolator::All;
+		TickInterpolators(DeltaTime, EShooterInterpolator::All);
+		SetTurnLookRate();
+	}
+	OutActiveNanoseconds = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / Iterations;
+
+	Hot.ActiveInterpolators = SavedInterpolators;
+}
+
+FShooterCrowdBenchmark AShooterCharacter::BenchmarkCrowd(const TArray<AShooterCharacter*>& Characters, int32 Passes)
+{
+	FShooterCrowdBenchmark Result;
+	if (Characters.Num() == 0 || Passes <= 0) return Result;
+
+	TArray<EShooterInterpolator> SavedInterpolators;
+	SavedInterpolators.Reserve(Characters.Num());
+	for (const AShooterCharacter* Character : Characters)
+	{
+		SavedInterpolators.Add(Character->Hot.ActiveInterpolators);
+	}
+	const double NumCharacterPasses{ static_cast<double>(Passes) * Characters.Num() };
+	const float DeltaTime{ 1.f / 60.f };
+	FCacheMissCounter CacheMisses;
+
+	CacheMisses.Start();
+	double StartTime{ FPlatformTime::Seconds() };
+	for (int32 Pass = 0; Pass < Passes; ++Pass)
+	{
+		for (AShooterCharacter* Character : Characters)
+		{
+			Character->Hot.ActiveInterpolators = EShooterInterpolator::All;
+			Character->TickInterpolators(DeltaTime, EShooterInterpolator::All);
+		}
+	}
+	Result.PerCharacterNanoseconds = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / NumCharacterPasses;
+	Result.PerCharacterCacheMisses = CacheMisses.Stop() / NumCharacterPasses;
+
+	// The same work with crosshair spread and FOV left to the cosmetics subsystem, which batches every registered character.
+	UCharacterCosmeticsSubsystem* Cosmetics{ Characters[0]->GetWorld()->GetSubsystem<UCharacterCosmeticsSubsystem>() };
+	if (Cosmetics)
+	{
+		CacheMisses.Start();
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < Passes; ++Pass)
+		{
+			for (AShooterCharacter* Character : Characters)
+			{
+				Character->Hot.ActiveInterpolators = EShooterInterpolator::All;
+				Character->TickInterpolators(DeltaTime, ~EShooterInterpolator::Cosmetics);
+			}
+			Cosmetics->RunBatch(DeltaTime);
+		}
+		Result.BatchedNanoseconds = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / NumCharacterPasses;
+		Result.BatchedCacheMisses = CacheMisses.Stop() / NumCharacterPasses;
+	}
+
+	for (int32 Index = 0; Index < Characters.Num(); ++Index)
+	{
+		Characters[Index]->Hot.ActiveInterpolators = SavedInterpolators[Index];
+	}
+	return Result;
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCharacterConfig.h"
+
+UShooterCharacterConfig::UShooterCharacterConfig() :
+	// Turn rate while aiming / not aiming - for console controller.
+	HipTurnRate(90.f),
+	HipLookUpRate(90.f),
+	AimingTurnRate(40.f),
+	AimingLookUpRate(40.f),
+	// Turn rate while aiming / not aiming - for mouse controller.
+	MouseHipTurnRate(1.0f),
+	MouseHipLookUpRate(1.0f),
+	MouseAimingTurnRate(0.66f),
+	MouseAimingLookUpRate(0.66f),
+	// Camera Field of View.
+	CameraZoomedFOV(28.f),
+	ZoomInterpSpeed(20.f),
+	// Used for bullet fire timer.
+	ShootTimeDuration(0.12f),
+	// Used for automatic weapon fire.
+	AutomaticFireRate(0.1f),
+	// Item trace
+	TargetingRate(20.f),
+	TargetingRadius(400.f),
+	TargetingConeAngle(20.f),
+	TargetingDistanceWeight(0.5f),
+	// For interpolating items being equipped momentarily to the front of player's view
+	CameraInterpDistance(250.f),
+	CameraInterpElevation(65.f),
+	// Ammo
+	Starting9mmAmmo(108),
+	StartingARAmmo(40),
+	MaxCarriedAmmo(999),
+	// Movement
+	BaseMovementSpeed(650.f),
+	CrouchMovementSpeed(300.f),
+	AimMovementSpeed(450.f),
+	CrouchingCapsuleHalfHeight(44.f),
+	// Underwater
+	SetUnderwaterTimerRate(0.2f),
+	UnderwaterCameraDepth(25.f),
+	// Animation
+	CrowdAnimationSetup(nullptr)
+{
+}
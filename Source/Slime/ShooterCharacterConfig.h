@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterCharacterConfig.generated.h"
+
+class UAnimationSharingSetup;
+
+/**
+ * Tuning shared by every character of a class: turn rates, zoom, fire timing, item targeting, starting ammo and
+ * movement speeds. A character class points at one of these instead of each character carrying its own copy; a class
+ * without one uses this class's defaults.
+ */
+UCLASS(BlueprintType)
+class SLIME_API UShooterCharacterConfig : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UShooterCharacterConfig();
+
+	/** Turn rate while NOT aiming. Console controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera)
+	float HipTurnRate;
+
+	/** Look up/down rate while NOT aiming. Console controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera)
+	float HipLookUpRate;
+
+	/** Turn rate while aiming. Console controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera)
+	float AimingTurnRate;
+
+	/** Look up/down rate while aiming. Console controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera)
+	float AimingLookUpRate;
+
+	/** Turn rate while NOT aiming. Mouse controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float MouseHipTurnRate;
+
+	/** Look up/down rate while NOT aiming. Mouse controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float MouseHipLookUpRate;
+
+	/** Turn rate while aiming. Mouse controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float MouseAimingTurnRate;
+
+	/** Look up/down rate while aiming. Mouse controller only. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float MouseAimingLookUpRate;
+
+	/** Field of view when zoomed in. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat)
+	float CameraZoomedFOV;
+
+	/** Speed to change camera from Default to Zoomed. Higher is faster. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat)
+	float ZoomInterpSpeed;
+
+	/** Seconds the crosshairs stay spread after a shot. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat)
+	float ShootTimeDuration;
+
+	/** Seconds between automatic shots. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat)
+	float AutomaticFireRate;
+
+	/** Item targeting updates per second. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items|Targeting", meta = (ClampMin = "1.0"))
+	float TargetingRate;
+
+	/** Items within this distance of the character can be targeted. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items|Targeting")
+	float TargetingRadius;
+
+	/** Items more than this many degrees off the view direction can't be targeted. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items|Targeting", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+	float TargetingConeAngle;
+
+	/** How much distance counts against an item's score, relative to its angle off the view direction. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Items|Targeting", meta = (ClampMin = "0.0"))
+	float TargetingDistanceWeight;
+
+	/** Distance outward from the camera for an interpolation destination, from item world location to in front of viewer. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items)
+	float CameraInterpDistance;
+
+	/** Distance upward from the camera for an interpolation destination, from item world location to in front of viewer. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items)
+	float CameraInterpElevation;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items)
+	int32 Starting9mmAmmo;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items)
+	int32 StartingARAmmo;
+
+	/** Most ammo of each type the character can carry. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (ClampMin = "0"))
+	int32 MaxCarriedAmmo;
+
+	/** Regular movement speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float BaseMovementSpeed;
+
+	/** Crouch walking movement speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float CrouchMovementSpeed;
+
+	/** Aim walking movement speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float AimMovementSpeed;
+
+	/** Half height of capsule when crouching. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float CrouchingCapsuleHalfHeight;
+
+	/** Seconds between surface checks while inside a water volume. Nothing is checked outside of one. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float SetUnderwaterTimerRate;
+
+	/** How far below the surface the camera has to be to count as under water. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float UnderwaterCameraDepth;
+
+	/**
+	 * Leader animations distant bots of this class share, one per EShooterCrowdAnimState, with
+	 * UShooterCrowdAnimStateProcessor as the state processor. Without one, every character runs its own anim instance.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Animation)
+	UAnimationSharingSetup* CrowdAnimationSetup;
+};
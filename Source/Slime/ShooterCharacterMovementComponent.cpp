@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCharacterMovementComponent.h"
+
+#include "GameFramework/Character.h"
+
+UShooterCharacterMovementComponent::UShooterCharacterMovementComponent() :
+	MaxWalkSpeedAiming(450.f),
+	bWantsToAim(false)
+{
+	NavAgentProps.bCanCrouch = true;
+
+	// Crouched characters could always walk off ledges.
+	bCanWalkOffLedgesWhenCrouching = true;
+}
+
+float UShooterCharacterMovementComponent::GetMaxSpeed() const
+{
+	if ((MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking) && bWantsToAim && !IsCrouching())
+	{
+		return MaxWalkSpeedAiming;
+	}
+	return Super::GetMaxSpeed();
+}
+
+void UShooterCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToAim = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+FNetworkPredictionData_Client* UShooterCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UShooterCharacterMovementComponent* MutableThis{ const_cast<UShooterCharacterMovementComponent*>(this) };
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Shooter(*this);
+	}
+	return ClientPredictionData;
+}
+
+bool UShooterCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	// Replayed moves set the aim input they were made with; put the live one back afterwards, as the engine does for crouching.
+	const bool bRealWantsToAim{ bWantsToAim != 0 };
+	const bool bReplayed{ Super::ClientUpdatePositionAfterServerUpdate() };
+	bWantsToAim = bRealWantsToAim;
+	return bReplayed;
+}
+
+FSavedMove_Shooter::FSavedMove_Shooter() :
+	bSavedWantsToAim(false)
+{
+}
+
+void FSavedMove_Shooter::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToAim = false;
+}
+
+uint8 FSavedMove_Shooter::GetCompressedFlags() const
+{
+	uint8 Flags{ Super::GetCompressedFlags() };
+	if (bSavedWantsToAim)
+	{
+		Flags |= FLAG_Custom_0;
+	}
+	return Flags;
+}
+
+bool FSavedMove_Shooter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	if (bSavedWantsToAim != static_cast<const FSavedMove_Shooter*>(NewMove.Get())->bSavedWantsToAim)
+	{
+		return false;
+	}
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Shooter::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UShooterCharacterMovementComponent* Movement = Cast<UShooterCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		bSavedWantsToAim = Movement->WantsToAim();
+	}
+}
+
+void FSavedMove_Shooter::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// Replayed moves use the aim input they were first made with.
+	if (UShooterCharacterMovementComponent* Movement = Cast<UShooterCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		Movement->SetWantsToAim(bSavedWantsToAim);
+	}
+}
+
+FNetworkPredictionData_Client_Shooter::FNetworkPredictionData_Client_Shooter(const UCharacterMovementComponent& ClientMovement) :
+	Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Shooter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Shooter());
+}
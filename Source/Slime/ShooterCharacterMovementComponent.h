@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ShooterCharacterMovementComponent.generated.h"
+
+/**
+ * Character movement with the shooter's aim walk speed. Crouching is the engine's: the capsule is resized once per
+ * crouch or uncrouch, inside the predicted move, and uncrouching waits until the standing capsule fits. The wish to aim
+ * travels with each saved move as a compressed flag, so the server moves an aiming client at the same speed it predicted.
+ */
+UCLASS()
+class SLIME_API UShooterCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UShooterCharacterMovementComponent();
+
+	virtual float GetMaxSpeed() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+	void SetWantsToAim(bool bAim) { bWantsToAim = bAim; }
+	FORCEINLINE bool WantsToAim() const { return bWantsToAim; }
+
+	/** Max walking speed while aiming and not crouched. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Walking", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxWalkSpeedAiming;
+
+private:
+	/** Aim input of the move being performed. */
+	uint8 bWantsToAim : 1;
+};
+
+/** A saved move that also remembers whether the character wanted to aim. */
+class FSavedMove_Shooter : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	FSavedMove_Shooter();
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	uint8 bSavedWantsToAim : 1;
+};
+
+class FNetworkPredictionData_Client_Shooter : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_Shooter(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCrowdAnimStateProcessor.h"
+#include "ShooterCharacter.h"
+
+UShooterCrowdAnimStateProcessor::UShooterCrowdAnimStateProcessor() :
+	RunSpeedThreshold(10.f)
+{
+}
+
+void UShooterCrowdAnimStateProcessor::ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess)
+{
+	const AShooterCharacter* Character{ Cast<AShooterCharacter>(InActor) };
+	if (Character == nullptr)
+	{
+		bShouldProcess = false;
+		return;
+	}
+
+	FVector Velocity{ Character->GetVelocity() };
+	Velocity.Z = 0.f;
+	const bool bRunning{ Velocity.SizeSquared() > FMath::Square(RunSpeedThreshold) };
+
+	EShooterCrowdAnimState State;
+	if (Character->GetCombatState() == ECombatState::ECS_Reloading)
+	{
+		State = EShooterCrowdAnimState::ECAS_Reload;
+	}
+	else if (Character->GetCrouching())
+	{
+		State = bRunning ? EShooterCrowdAnimState::ECAS_CrouchRun : EShooterCrowdAnimState::ECAS_CrouchIdle;
+	}
+	else
+	{
+		State = bRunning ? EShooterCrowdAnimState::ECAS_Run : EShooterCrowdAnimState::ECAS_Idle;
+	}
+
+	OutState = static_cast<int32>(State);
+	bShouldProcess = true;
+}
+
+UEnum* UShooterCrowdAnimStateProcessor::GetAnimationStateEnum_Implementation()
+{
+	return StaticEnum<EShooterCrowdAnimState>();
+}
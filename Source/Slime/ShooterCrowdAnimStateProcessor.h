@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationSharingTypes.h"
+#include "ShooterCrowdAnimStateProcessor.generated.h"
+
+/** States a shared crowd animation setup has a leader pose for. */
+UENUM(BlueprintType)
+enum class EShooterCrowdAnimState : uint8
+{
+	ECAS_Idle UMETA(DisplayName = "Idle"),
+	ECAS_Run UMETA(DisplayName = "Run"),
+	ECAS_CrouchIdle UMETA(DisplayName = "CrouchIdle"),
+	ECAS_CrouchRun UMETA(DisplayName = "CrouchRun"),
+	ECAS_Reload UMETA(DisplayName = "Reload"),
+
+	ECAS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/**
+ * Picks the EShooterCrowdAnimState of a shared shooter character from its movement and combat state. Set as the
+ * state processor of the UAnimationSharingSetup in UShooterCharacterConfig::CrowdAnimationSetup.
+ */
+UCLASS()
+class SLIME_API UShooterCrowdAnimStateProcessor : public UAnimationSharingStateProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UShooterCrowdAnimStateProcessor();
+
+	virtual void ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess) override;
+	virtual UEnum* GetAnimationStateEnum_Implementation() override;
+
+private:
+	/** Lateral speed above which a character counts as running. */
+	UPROPERTY(EditAnywhere, Category = AnimationSharing, meta = (AllowPrivateAccess = "true"))
+	float RunSpeedThreshold;
+};
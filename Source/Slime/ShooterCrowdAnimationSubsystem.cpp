@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCrowdAnimationSubsystem.h"
+
+#include "ShooterCharacter.h"
+#include "AnimationSharingManager.h"
+#include "SignificanceManager.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+static TAutoConsoleVariable<int32> CVarCrowdSharedAnimation(
+	TEXT("slime.Crowd.SharedAnimation"),
+	1,
+	TEXT("1: distant bots copy shared leader poses instead of running their own anim instances. 0: every character runs its own."),
+	ECVF_Default);
+
+namespace
+{
+	/** Significance manager tag of shared characters. */
+	const FName CrowdSignificanceTag{ TEXT("ShooterCrowd") };
+}
+
+bool UShooterCrowdAnimationSubsystem::IsEnabled()
+{
+	return CVarCrowdSharedAnimation.GetValueOnGameThread() != 0;
+}
+
+void UShooterCrowdAnimationSubsystem::SetShared(AShooterCharacter* Character, bool bShared, float Significance)
+{
+	if (!bShared || !IsEnabled())
+	{
+		if (IsShared(Character))
+		{
+			Unshare(Character);
+		}
+		return;
+	}
+
+	if (float* SharedCharacterSignificance = SharedSignificance.Find(Character))
+	{
+		*SharedCharacterSignificance = Significance;
+		return;
+	}
+	Share(Character, Significance);
+}
+
+void UShooterCrowdAnimationSubsystem::UpdateSignificance(TArrayView<const FTransform> Viewpoints)
+{
+	if (SharedSignificance.Num() == 0) return;
+
+	if (USignificanceManager* Significance = USignificanceManager::Get(GetWorld()))
+	{
+		Significance->Update(Viewpoints);
+	}
+}
+
+void UShooterCrowdAnimationSubsystem::Deinitialize()
+{
+	SharedSignificance.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UShooterCrowdAnimationSubsystem::EnsureSharingManager(const AShooterCharacter* Character)
+{
+	if (UAnimationSharingManager::GetAnimationSharingManager(GetWorld())) return true;
+
+	// One setup serves the whole world; it holds a setup per skeleton, so the first character's config should cover all.
+	const UAnimationSharingSetup* Setup{ Character->GetConfig().CrowdAnimationSetup };
+	return Setup && UAnimationSharingManager::CreateAnimationSharingManager(GetWorld(), Setup);
+}
+
+void UShooterCrowdAnimationSubsystem::Share(AShooterCharacter* Character, float Significance)
+{
+	USkeletalMeshComponent* Mesh{ Character->GetMesh() };
+	if (Mesh->SkeletalMesh == nullptr || !EnsureSharingManager(Character)) return;
+
+	USignificanceManager* SignificanceManager{ USignificanceManager::Get(GetWorld()) };
+	UAnimationSharingManager* SharingManager{ UAnimationSharingManager::GetAnimationSharingManager(GetWorld()) };
+	if (SignificanceManager == nullptr || SharingManager == nullptr) return;
+
+	// Significance is in place before the sharing manager first asks for it. Called from the significance manager's
+	// update, possibly in parallel, while SharedSignificance is only read.
+	SharedSignificance.Add(Character, Significance);
+	SignificanceManager->RegisterObject(Character, CrowdSignificanceTag,
+		[this](USignificanceManager::FManagedObjectInfo* Info, const FTransform&)
+		{
+			return SharedSignificance.FindRef(static_cast<AShooterCharacter*>(Info->GetObject()));
+		});
+
+	// The sharing manager takes over the mesh's tick, so the budget allocator lets go of it first.
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Mesh))
+	{
+		if (IAnimationBudgetAllocator* Budget = IAnimationBudgetAllocator::Get(GetWorld()))
+		{
+			Budget->UnregisterComponent(BudgetedMesh);
+		}
+	}
+	SharingManager->RegisterActorWithSkeletonBP(Character, Mesh->SkeletalMesh->Skeleton);
+}
+
+void UShooterCrowdAnimationSubsystem::Unshare(AShooterCharacter* Character)
+{
+	SharedSignificance.Remove(Character);
+
+	if (UAnimationSharingManager* SharingManager = UAnimationSharingManager::GetAnimationSharingManager(GetWorld()))
+	{
+		SharingManager->UnregisterActor(Character);
+	}
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterObject(Character);
+	}
+
+	// Back on its own anim instance, which restarts turn in place and lean after the gap.
+	USkeletalMeshComponent* Mesh{ Character->GetMesh() };
+	Mesh->SetComponentTickEnabled(true);
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Mesh))
+	{
+		// Ignored while the allocator is off.
+		if (IAnimationBudgetAllocator* Budget = IAnimationBudgetAllocator::Get(GetWorld()))
+		{
+			Budget->RegisterComponent(BudgetedMesh);
+		}
+	}
+}
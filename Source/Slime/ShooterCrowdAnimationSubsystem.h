@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCrowdAnimationSubsystem.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * Moves distant bots off their own UShooterAnimInstance and onto shared leader poses through the engine's animation
+ * sharing manager: one leader pose is evaluated per EShooterCrowdAnimState, and followers copy it, blending only on a
+ * state change. UShooterSignificanceSubsystem decides who is shared; nearby characters and players never are.
+ * Needs a UShooterCharacterConfig::CrowdAnimationSetup. Toggled by slime.Crowd.SharedAnimation.
+ *
+ * The sharing manager reads significance from the engine's significance manager, so shared characters are registered
+ * there too, with the significance UShooterSignificanceSubsystem computed for them.
+ */
+UCLASS()
+class SLIME_API UShooterCrowdAnimationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Reads slime.Crowd.SharedAnimation. */
+	static bool IsEnabled();
+
+	/** Shares Character's animation, or gives it back its own anim instance. Significance is higher for nearer. */
+	void SetShared(AShooterCharacter* Character, bool bShared, float Significance);
+
+	FORCEINLINE bool IsShared(const AShooterCharacter* Character) const { return SharedSignificance.Contains(Character); }
+	FORCEINLINE int32 GetNumShared() const { return SharedSignificance.Num(); }
+
+	/** Updates the significance manager from the player viewpoints, after new significances were set. */
+	void UpdateSignificance(TArrayView<const FTransform> Viewpoints);
+
+protected:
+	virtual void Deinitialize() override;
+
+private:
+	/** Creates the world's sharing manager from Character's config if there is none yet. */
+	bool EnsureSharingManager(const AShooterCharacter* Character);
+
+	void Share(AShooterCharacter* Character, float Significance);
+	void Unshare(AShooterCharacter* Character);
+
+	/** Shared characters, with their significance. */
+	TMap<AShooterCharacter*, float> SharedSignificance;
+};
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUDModel.h"
+
+#include "Slime.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Change Sets"), STAT_HUDChangeSets, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarUseHUDModel(
+	TEXT("slime.HUD.UseModel"),
+	1,
+	TEXT("1: HUD updates are coalesced into one change set per frame. 0: every change is broadcast to the HUD as it happens."),
+	ECVF_Default);
+
+UShooterHUDModel::UShooterHUDModel()
+{
+	Current.CarriedAmmo.Init(0, static_cast<int32>(EAmmoType::EAT_MAX));
+}
+
+bool UShooterHUDModel::IsEnabled()
+{
+	return CVarUseHUDModel.GetValueOnGameThread() != 0;
+}
+
+void UShooterHUDModel::SetMagazineAmmo(int32 Ammo, int32 Capacity)
+{
+	if (Current.MagazineAmmo == Ammo && Current.MagazineCapacity == Capacity) return;
+
+	Current.MagazineAmmo = Ammo;
+	Current.MagazineCapacity = Capacity;
+	MarkChanged(EHUDModelField::EHF_MagazineAmmo);
+}
+
+void UShooterHUDModel::SetCarriedAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	const int32 Index{ static_cast<int32>(AmmoType) };
+	if (!Current.CarriedAmmo.IsValidIndex(Index) || Current.CarriedAmmo[Index] == Amount) return;
+
+	Current.CarriedAmmo[Index] = Amount;
+	MarkChanged(EHUDModelField::EHF_CarriedAmmo);
+}
+
+void UShooterHUDModel::MarkInventorySlotChanged(int32 SlotIndex)
+{
+	if (SlotIndex < 0 || SlotIndex >= 32) return;
+
+	PendingSlots |= 1 << SlotIndex;
+	MarkChanged(EHUDModelField::EHF_InventorySlots);
+}
+
+void UShooterHUDModel::SetEquippedSlot(int32 SlotIndex)
+{
+	if (Current.EquippedSlot == SlotIndex) return;
+
+	// Keep the slot from the start of the frame, so the widget un-highlights the one it actually showed.
+	if (!EnumHasAnyFlags(PendingFields, EHUDModelField::EHF_EquippedSlot))
+	{
+		Current.PreviousEquippedSlot = Current.EquippedSlot;
+	}
+	Current.EquippedSlot = SlotIndex;
+	MarkChanged(EHUDModelField::EHF_EquippedSlot);
+}
+
+void UShooterHUDModel::SetHighlightedSlot(int32 SlotIndex)
+{
+	if (Current.HighlightedSlot == SlotIndex) return;
+
+	if (!EnumHasAnyFlags(PendingFields, EHUDModelField::EHF_HighlightedSlot))
+	{
+		Current.PreviousHighlightedSlot = Current.HighlightedSlot;
+	}
+	Current.HighlightedSlot = SlotIndex;
+	MarkChanged(EHUDModelField::EHF_HighlightedSlot);
+}
+
+void UShooterHUDModel::SetCombatState(ECombatState CombatState)
+{
+	if (Current.CombatState == CombatState) return;
+
+	Current.CombatState = CombatState;
+	MarkChanged(EHUDModelField::EHF_CombatState);
+}
+
+void UShooterHUDModel::MarkChanged(EHUDModelField Field)
+{
+	PendingFields |= Field;
+}
+
+void UShooterHUDModel::Tick(float DeltaTime)
+{
+	// A highlight that started and ended within the frame is no change at all.
+	if (EnumHasAnyFlags(PendingFields, EHUDModelField::EHF_HighlightedSlot) && Current.HighlightedSlot == Current.PreviousHighlightedSlot)
+	{
+		PendingFields &= ~EHUDModelField::EHF_HighlightedSlot;
+	}
+	if (EnumHasAnyFlags(PendingFields, EHUDModelField::EHF_EquippedSlot) && Current.EquippedSlot == Current.PreviousEquippedSlot)
+	{
+		PendingFields &= ~EHUDModelField::EHF_EquippedSlot;
+	}
+
+	Current.ChangedFields = static_cast<int32>(PendingFields);
+	Current.ChangedSlots = PendingSlots;
+	PendingFields = EHUDModelField::EHF_None;
+	PendingSlots = 0;
+	if (Current.ChangedFields == 0) return;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HUDWidgetUpdates);
+		INC_DWORD_STAT(STAT_HUDChangeSets);
+		OnChanged.Broadcast(Current);
+		if (AShooterCharacter* Character = Cast<AShooterCharacter>(GetOuter()))
+		{
+			Character->ForwardHUDChanges(Current);
+		}
+	}
+	Current.ChangedFields = 0;
+	Current.ChangedSlots = 0;
+}
+
+bool UShooterHUDModel::IsTickable() const
+{
+	return !IsTemplate() && PendingFields != EHUDModelField::EHF_None;
+}
+
+TStatId UShooterHUDModel::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterHUDModel, STATGROUP_Tickables);
+}
+
+UWorld* UShooterHUDModel::GetWorld() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? nullptr : GetOuter()->GetWorld();
+}
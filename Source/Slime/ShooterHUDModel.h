@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+#include "AmmoType.h"
+#include "ShooterCharacter.h"
+#include "ShooterHUDModel.generated.h"
+
+/** Fields of the HUD model. A change set has the bit set for every field that changed since the last one. */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EHUDModelField : uint8
+{
+	EHF_None = 0 UMETA(Hidden),
+	EHF_MagazineAmmo = 1 << 0 UMETA(DisplayName = "MagazineAmmo"),
+	EHF_CarriedAmmo = 1 << 1 UMETA(DisplayName = "CarriedAmmo"),
+	EHF_InventorySlots = 1 << 2 UMETA(DisplayName = "InventorySlots"),
+	EHF_HighlightedSlot = 1 << 3 UMETA(DisplayName = "HighlightedSlot"),
+	EHF_EquippedSlot = 1 << 4 UMETA(DisplayName = "EquippedSlot"),
+	EHF_CombatState = 1 << 5 UMETA(DisplayName = "CombatState")
+};
+ENUM_CLASS_FLAGS(EHUDModelField);
+
+/** Everything the HUD shows, and which parts of it changed this frame. */
+USTRUCT(BlueprintType)
+struct FHUDModelChangeSet
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, meta = (Bitmask, BitmaskEnum = "EHUDModelField"))
+	int32 ChangedFields{ 0 };
+
+	/** Bit per inventory slot whose contents changed. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 ChangedSlots{ 0 };
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 MagazineAmmo{ 0 };
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 MagazineCapacity{ 0 };
+
+	/** Carried ammo, indexed by EAmmoType. */
+	UPROPERTY(BlueprintReadOnly)
+	TArray<int32> CarriedAmmo;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 EquippedSlot{ -1 };
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 PreviousEquippedSlot{ -1 };
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 HighlightedSlot{ -1 };
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 PreviousHighlightedSlot{ -1 };
+
+	UPROPERTY(BlueprintReadOnly)
+	ECombatState CombatState{ ECombatState::ECS_Unoccupied };
+
+	FORCEINLINE bool HasChanged(EHUDModelField Field) const { return (ChangedFields & static_cast<int32>(Field)) != 0; }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHUDModelChangedDelegate, const FHUDModelChangeSet&, Changes);
+
+/**
+ * Native view-model for the HUD. The character pushes values in as they change; setting a field to its current value
+ * is free, and any number of changes within a frame are published as one change set at the end of it.
+ * Widgets bind OnChanged and only update the parts whose bits are set, instead of polling through property bindings.
+ *
+ * slime.HUD.UseModel 0 makes the character broadcast its per-event delegates directly instead, for comparison.
+ * Both paths count their widget update time under the "HUD Widget Updates" stat.
+ */
+UCLASS(BlueprintType)
+class SLIME_API UShooterHUDModel : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UShooterHUDModel();
+
+	/** Reads slime.HUD.UseModel. */
+	static bool IsEnabled();
+
+	void SetMagazineAmmo(int32 Ammo, int32 Capacity);
+	void SetCarriedAmmo(EAmmoType AmmoType, int32 Amount);
+	void MarkInventorySlotChanged(int32 SlotIndex);
+	void SetEquippedSlot(int32 SlotIndex);
+	void SetHighlightedSlot(int32 SlotIndex);
+	void SetCombatState(ECombatState CombatState);
+
+	/** Current values, with no fields marked as changed. */
+	UFUNCTION(BlueprintPure, Category = HUD)
+	FHUDModelChangeSet GetState() const { return Current; }
+
+	/** Broadcast at most once per frame, with the fields that changed. */
+	UPROPERTY(BlueprintAssignable, Category = HUD)
+	FHUDModelChangedDelegate OnChanged;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	virtual UWorld* GetWorld() const override;
+
+private:
+	void MarkChanged(EHUDModelField Field);
+
+	UPROPERTY(Transient)
+	FHUDModelChangeSet Current;
+
+	EHUDModelField PendingFields{ EHUDModelField::EHF_None };
+	int32 PendingSlots{ 0 };
+};
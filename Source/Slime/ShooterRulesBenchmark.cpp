@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "AmmoType.h"
+#include "ShooterRules.h"
+#include "Slime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	typedef ShooterRules::TAmmoLedger<EAmmoType, static_cast<int32>(EAmmoType::EAT_MAX)> FAmmoLedger;
+
+	struct FRulesInput
+	{
+		EAmmoType AmmoType;
+		int32 MagazineAmmo;
+		int32 StackCount;
+	};
+
+	constexpr int32 MagazineCapacity{ 30 };
+	constexpr int32 MaxCarriedAmmo{ 200 };
+
+	/** The TMap reload the character used before the ledger, kept for comparison. */
+	int32 ReloadWithMap(TMap<EAmmoType, int32>& AmmoMap, const FRulesInput& Input)
+	{
+		if (!AmmoMap.Contains(Input.AmmoType)) return 0;
+
+		int32 CarriedAmmo = AmmoMap[Input.AmmoType];
+		const int32 MagEmptySpace = MagazineCapacity - Input.MagazineAmmo;
+		if (MagEmptySpace > CarriedAmmo)
+		{
+			const int32 Loaded{ CarriedAmmo };
+			AmmoMap.Add(Input.AmmoType, 0);
+			return Loaded;
+		}
+		AmmoMap.Add(Input.AmmoType, CarriedAmmo - MagEmptySpace);
+		return MagEmptySpace;
+	}
+
+	/** The TMap pickup the character used before the ledger, kept for comparison. */
+	int32 PickupWithMap(TMap<EAmmoType, int32>& AmmoMap, const FRulesInput& Input)
+	{
+		if (!AmmoMap.Find(Input.AmmoType)) return 0;
+
+		int32 AmmoCount{ AmmoMap[Input.AmmoType] };
+		AmmoCount = FMath::Min(AmmoCount + Input.StackCount, MaxCarriedAmmo);
+		AmmoMap[Input.AmmoType] = AmmoCount;
+		return AmmoCount;
+	}
+
+	template <typename BodyType>
+	double TimeNanosecondsPerCall(int32 Iterations, BodyType&& Body)
+	{
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			Body(Index);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1.0e9 / Iterations;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs RulesBenchmarkCommand(
+	TEXT("slime.Rules.Benchmark"),
+	TEXT("Times the reload and pickup ammo math with the TMap ledger and with ShooterRules::TAmmoLedger. Optional argument: iterations (default 1000000)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations{ FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000000, 1) };
+
+		// Random inputs, so neither version can be folded away. A power of two keeps the index a mask.
+		constexpr int32 NumInputs{ 4096 };
+		FRandomStream Random(0x5117E);
+		TArray<FRulesInput> Inputs;
+		Inputs.SetNumUninitialized(NumInputs);
+		for (FRulesInput& Input : Inputs)
+		{
+			Input.AmmoType = static_cast<EAmmoType>(Random.RandRange(0, static_cast<int32>(EAmmoType::EAT_MAX) - 1));
+			Input.MagazineAmmo = Random.RandRange(0, MagazineCapacity);
+			Input.StackCount = Random.RandRange(1, 60);
+		}
+
+		TMap<EAmmoType, int32> AmmoMap;
+		FAmmoLedger Ledger;
+		auto Refill = [&AmmoMap, &Ledger]()
+		{
+			for (int32 Index = 0; Index < FAmmoLedger::Num(); ++Index)
+			{
+				AmmoMap.Add(static_cast<EAmmoType>(Index), MaxCarriedAmmo / 2);
+				Ledger.Set(static_cast<EAmmoType>(Index), MaxCarriedAmmo / 2);
+			}
+		};
+
+		int64 Checksum{ 0 };
+		Refill();
+		const double MapReload{ TimeNanosecondsPerCall(Iterations, [&](int32 Index)
+		{
+			const FRulesInput& Input{ Inputs[Index & (NumInputs - 1)] };
+			Checksum += ReloadWithMap(AmmoMap, Input);
+			Checksum += PickupWithMap(AmmoMap, Input) & 1;  // Refills the pouch, so reloads keep having work to do.
+		}) };
+		Refill();
+		const double LedgerReload{ TimeNanosecondsPerCall(Iterations, [&](int32 Index)
+		{
+			const FRulesInput& Input{ Inputs[Index & (NumInputs - 1)] };
+			Checksum += Ledger.Reload(Input.AmmoType, Input.MagazineAmmo, MagazineCapacity);
+			Checksum += Ledger.Pickup(Input.AmmoType, Input.StackCount, MaxCarriedAmmo) & 1;
+		}) };
+
+		Refill();
+		const double MapSpace{ TimeNanosecondsPerCall(Iterations, [&](int32 Index)
+		{
+			const FRulesInput& Input{ Inputs[Index & (NumInputs - 1)] };
+			const int32* CarriedAmmo{ AmmoMap.Find(Input.AmmoType) };
+			Checksum += CarriedAmmo ? FMath::Max(MaxCarriedAmmo - *CarriedAmmo, 0) : 0;
+		}) };
+		const double LedgerSpace{ TimeNanosecondsPerCall(Iterations, [&](int32 Index)
+		{
+			const FRulesInput& Input{ Inputs[Index & (NumInputs - 1)] };
+			Checksum += Ledger.GetSpace(Input.AmmoType, MaxCarriedAmmo);
+		}) };
+
+		UE_LOG(LogSlime, Display, TEXT("Ammo rules, %d iterations (checksum %lld):"), Iterations, Checksum);
+		UE_LOG(LogSlime, Display, TEXT("  Reload + pickup: TMap %.2f ns, ledger %.2f ns"), MapReload, LedgerReload);
+		UE_LOG(LogSlime, Display, TEXT("  Ammo space:      TMap %.2f ns, ledger %.2f ns"), MapSpace, LedgerSpace);
+	}));
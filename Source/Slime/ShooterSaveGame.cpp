@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterSaveGame.h"
+
+#include "Misc/Compression.h"
+
+FArchive& operator<<(FArchive& Ar, FShooterSavedWeapon& Weapon)
+{
+	return Ar << Weapon.ClassPath << Weapon.AmmoCount << Weapon.WeaponType << Weapon.Rarity;
+}
+
+FArchive& operator<<(FArchive& Ar, FShooterPlayerSaveState& State)
+{
+	return Ar << State.Inventory << State.EquippedSlot << State.CarriedAmmo;
+}
+
+bool FShooterSavedItem::operator==(const FShooterSavedItem& Other) const
+{
+	return Id == Other.Id
+		&& ClassIndex == Other.ClassIndex
+		&& Rarity == Other.Rarity
+		&& SubType == Other.SubType
+		&& Count == Other.Count
+		&& AmmoCount == Other.AmmoCount
+		&& Location == Other.Location
+		&& Yaw == Other.Yaw;
+}
+
+FArchive& operator<<(FArchive& Ar, FShooterSavedItem& Item)
+{
+	return Ar << Item.Id << Item.ClassIndex << Item.Rarity << Item.SubType << Item.Count << Item.AmmoCount << Item.Location << Item.Yaw;
+}
+
+void FShooterSaveSnapshot::Encode(FArchive& Ar, const FShooterSaveSnapshot* Base)
+{
+	check(Ar.IsSaving());
+
+	Items.Sort([](const FShooterSavedItem& A, const FShooterSavedItem& B) { return A.Id < B.Id; });
+
+	uint8 bDelta{ Base != nullptr };
+	Ar << bDelta << MapName << Player << ItemClassPaths;
+	if (Base == nullptr)
+	{
+		Ar << Items << ConsumedRecords;
+		return;
+	}
+
+	// Both lists are sorted by id, so one walk finds every removed, added and changed item.
+	TArray<uint32> RemovedIds;
+	TArray<FShooterSavedItem> ChangedItems;
+	int32 BaseIndex{ 0 };
+	for (const FShooterSavedItem& Item : Items)
+	{
+		while (BaseIndex < Base->Items.Num() && Base->Items[BaseIndex].Id < Item.Id)
+		{
+			RemovedIds.Add(Base->Items[BaseIndex++].Id);
+		}
+
+		if (BaseIndex < Base->Items.Num() && Base->Items[BaseIndex].Id == Item.Id)
+		{
+			if (!(Base->Items[BaseIndex++] == Item))
+			{
+				ChangedItems.Add(Item);
+			}
+		}
+		else
+		{
+			ChangedItems.Add(Item);
+		}
+	}
+	while (BaseIndex < Base->Items.Num())
+	{
+		RemovedIds.Add(Base->Items[BaseIndex++].Id);
+	}
+	Ar << RemovedIds << ChangedItems;
+
+	// A few records are consumed between saves, so only the flipped ones are written.
+	uint8 bWholeRecords{ ConsumedRecords.Num() != Base->ConsumedRecords.Num() };
+	Ar << bWholeRecords;
+	if (bWholeRecords)
+	{
+		Ar << ConsumedRecords;
+		return;
+	}
+
+	TArray<int32> FlippedRecords;
+	for (int32 Index = 0; Index < ConsumedRecords.Num(); ++Index)
+	{
+		if (ConsumedRecords[Index] != Base->ConsumedRecords[Index])
+		{
+			FlippedRecords.Add(Index);
+		}
+	}
+	Ar << FlippedRecords;
+}
+
+bool FShooterSaveSnapshot::Decode(FArchive& Ar, const FShooterSaveSnapshot* Base)
+{
+	check(Ar.IsLoading());
+
+	uint8 bDelta{ 0 };
+	Ar << bDelta << MapName << Player << ItemClassPaths;
+	if (!bDelta)
+	{
+		Ar << Items << ConsumedRecords;
+		return !Ar.IsError();
+	}
+
+	if (Base == nullptr || Base->ItemClassPaths.Num() > ItemClassPaths.Num()) return false;
+
+	TArray<uint32> RemovedIds;
+	TArray<FShooterSavedItem> ChangedItems;
+	Ar << RemovedIds << ChangedItems;
+	if (Ar.IsError()) return false;
+
+	// Merge the sorted lists: changed items replace or join the base's, and removed ones are dropped.
+	const TSet<uint32> Removed(RemovedIds);
+	Items.Reset(Base->Items.Num() + ChangedItems.Num());
+	int32 ChangedIndex{ 0 };
+	for (const FShooterSavedItem& BaseItem : Base->Items)
+	{
+		while (ChangedIndex < ChangedItems.Num() && ChangedItems[ChangedIndex].Id < BaseItem.Id)
+		{
+			Items.Add(ChangedItems[ChangedIndex++]);
+		}
+
+		if (ChangedIndex < ChangedItems.Num() && ChangedItems[ChangedIndex].Id == BaseItem.Id)
+		{
+			Items.Add(ChangedItems[ChangedIndex++]);
+		}
+		else if (!Removed.Contains(BaseItem.Id))
+		{
+			Items.Add(BaseItem);
+		}
+	}
+	while (ChangedIndex < ChangedItems.Num())
+	{
+		Items.Add(ChangedItems[ChangedIndex++]);
+	}
+
+	uint8 bWholeRecords{ 0 };
+	Ar << bWholeRecords;
+	if (bWholeRecords)
+	{
+		Ar << ConsumedRecords;
+		return !Ar.IsError();
+	}
+
+	TArray<int32> FlippedRecords;
+	Ar << FlippedRecords;
+	ConsumedRecords = Base->ConsumedRecords;
+	for (const int32 Index : FlippedRecords)
+	{
+		if (!ConsumedRecords.IsValidIndex(Index)) return false;
+
+		ConsumedRecords[Index] = !ConsumedRecords[Index];
+	}
+	return !Ar.IsError();
+}
+
+bool UShooterSaveGame::CompressPayload(const TArray<uint8>& Uncompressed, TArray<uint8>& OutCompressed)
+{
+	int32 CompressedSize{ FCompression::CompressMemoryBound(NAME_Zlib, Uncompressed.Num()) };
+	OutCompressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, OutCompressed.GetData(), CompressedSize, Uncompressed.GetData(), Uncompressed.Num()))
+	{
+		OutCompressed.Reset();
+		return false;
+	}
+	OutCompressed.SetNum(CompressedSize, false);
+	return true;
+}
+
+bool UShooterSaveGame::DecompressPayload(const TArray<uint8>& Compressed, int32 UncompressedSize, TArray<uint8>& OutUncompressed)
+{
+	if (UncompressedSize < 0) return false;
+
+	OutUncompressed.SetNumUninitialized(UncompressedSize);
+	return FCompression::UncompressMemory(NAME_Zlib, OutUncompressed.GetData(), UncompressedSize, Compressed.GetData(), Compressed.Num());
+}
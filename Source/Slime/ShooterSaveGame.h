@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "ShooterSaveGame.generated.h"
+
+/** A weapon in an inventory slot. An empty ClassPath is an empty slot. */
+struct FShooterSavedWeapon
+{
+	FString ClassPath;
+	int32 AmmoCount{ 0 };
+	uint8 WeaponType{ 0 };
+	uint8 Rarity{ 0 };
+
+	friend FArchive& operator<<(FArchive& Ar, FShooterSavedWeapon& Weapon);
+};
+
+/** Inventory, equipped slot and carried ammo of the player character. */
+struct FShooterPlayerSaveState
+{
+	TArray<FShooterSavedWeapon> Inventory;
+	int32 EquippedSlot{ INDEX_NONE };
+
+	/** Carried ammo, indexed by EAmmoType. */
+	TArray<int32> CarriedAmmo;
+
+	friend FArchive& operator<<(FArchive& Ar, FShooterPlayerSaveState& State);
+};
+
+/** An item lying on the ground. */
+struct FShooterSavedItem
+{
+	/** The item's save id, see AItem::GetSaveId(). */
+	uint32 Id{ 0 };
+	/** Index into the snapshot's ItemClassPaths. */
+	uint16 ClassIndex{ 0 };
+	uint8 Rarity{ 0 };
+	/** EWeaponType or EAmmoType, depending on the class. */
+	uint8 SubType{ 0 };
+	int32 Count{ 0 };
+	/** Loaded ammo, for weapons. */
+	int32 AmmoCount{ 0 };
+	FVector Location{ FVector::ZeroVector };
+	float Yaw{ 0.f };
+
+	bool operator==(const FShooterSavedItem& Other) const;
+	friend FArchive& operator<<(FArchive& Ar, FShooterSavedItem& Item);
+};
+
+/**
+ * Everything a save holds, as plain data, so it can be encoded and decoded away from the game thread.
+ * A delta stores the player whole (it is a few hundred bytes), and only the items added, changed or removed since its base.
+ */
+struct FShooterSaveSnapshot
+{
+	FString MapName;
+	FShooterPlayerSaveState Player;
+
+	/**
+	 * Class of each saved item. Within a session the table only grows, so a base's indices are still valid in
+	 * every delta written against it.
+	 */
+	TArray<FString> ItemClassPaths;
+
+	/** Ground items that aren't streamed from the map's placement table, sorted by id once encoded. */
+	TArray<FShooterSavedItem> Items;
+
+	/** Consumed records of the map's item placement table. Empty if the map streams no items. */
+	TBitArray<> ConsumedRecords;
+
+	/** Writes the snapshot, or only its differences from Base if one is given. Sorts Items. */
+	void Encode(FArchive& Ar, const FShooterSaveSnapshot* Base);
+
+	/** Reads a snapshot written by Encode(). A delta needs the base it was written against. */
+	bool Decode(FArchive& Ar, const FShooterSaveSnapshot* Base);
+};
+
+/**
+ * Save slot contents: a compressed snapshot, or a delta against the base snapshot with id BaseId.
+ * Bases and deltas live in separate slots, see UShooterSaveSubsystem.
+ */
+UCLASS()
+class SLIME_API UShooterSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	/** Bump when the snapshot encoding changes. Saves of another version are not loaded. */
+	static constexpr int32 FORMAT_VERSION{ 1 };
+
+	/** Zlib-compresses an encoded snapshot. Safe off the game thread. */
+	static bool CompressPayload(const TArray<uint8>& Uncompressed, TArray<uint8>& OutCompressed);
+	static bool DecompressPayload(const TArray<uint8>& Compressed, int32 UncompressedSize, TArray<uint8>& OutUncompressed);
+
+	UPROPERTY()
+	int32 FormatVersion{ FORMAT_VERSION };
+
+	UPROPERTY()
+	bool bDelta{ false };
+
+	/** Id of the base: this save's own if it is one, or the one it was written against if it is a delta. */
+	UPROPERTY()
+	FGuid BaseId;
+
+	UPROPERTY()
+	int32 UncompressedSize{ 0 };
+
+	UPROPERTY()
+	TArray<uint8> Payload;
+};
@@ -0,0 +1,554 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterSaveSubsystem.h"
+
+#include "Ammo.h"
+#include "Item.h"
+#include "ItemStreamingSubsystem.h"
+#include "ItemWorldSubsystem.h"
+#include "ShooterCharacter.h"
+#include "Slime.h"
+#include "Weapon.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/PackageName.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Save Capture"), STAT_SaveCapture, STATGROUP_Slime);
+DECLARE_CYCLE_STAT(TEXT("Save Restore Items"), STAT_SaveRestoreItems, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarSaveDeltasPerBase(
+	TEXT("slime.Save.DeltasPerBase"),
+	8,
+	TEXT("Saves written as a delta against the slot's base before a whole new base is written. 0 writes every save whole."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSaveRestoreBudgetMs(
+	TEXT("slime.Save.RestoreBudgetMs"),
+	1.f,
+	TEXT("Game thread time per frame spent replacing ground items when a save is loaded. At least one item is handled per frame."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs SaveCommand(
+	TEXT("slime.Save"),
+	TEXT("Saves the player and ground items to a slot, 'Slot0' by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GameInstance{ World ? World->GetGameInstance() : nullptr };
+		if (UShooterSaveSubsystem* SaveSubsystem = GameInstance ? GameInstance->GetSubsystem<UShooterSaveSubsystem>() : nullptr)
+		{
+			SaveSubsystem->SaveToSlot(Args.Num() > 0 ? Args[0] : TEXT("Slot0"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs LoadCommand(
+	TEXT("slime.Load"),
+	TEXT("Restores the player and ground items from a slot, 'Slot0' by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GameInstance{ World ? World->GetGameInstance() : nullptr };
+		if (UShooterSaveSubsystem* SaveSubsystem = GameInstance ? GameInstance->GetSubsystem<UShooterSaveSubsystem>() : nullptr)
+		{
+			SaveSubsystem->LoadFromSlot(Args.Num() > 0 ? Args[0] : TEXT("Slot0"));
+		}
+	}));
+
+static FString GetSaveMapName(const UWorld* World)
+{
+	return UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost()));
+}
+
+void UShooterSaveSubsystem::Deinitialize()
+{
+	BaseSnapshot.Reset();
+	LoadedBase = nullptr;
+	RestoreClasses.Empty();
+	ItemsToDestroy.Empty();
+	ItemsToRestore.Empty();
+
+	Super::Deinitialize();
+}
+
+FString UShooterSaveSubsystem::GetDeltaSlotName(const FString& SlotName)
+{
+	return SlotName + TEXT("_Delta");
+}
+
+bool UShooterSaveSubsystem::IsBusy() const
+{
+	return bSaveInFlight || bLoadInFlight || ItemsToDestroy.Num() > 0 || ItemsToRestore.Num() > 0;
+}
+
+UWorld* UShooterSaveSubsystem::GetGameWorld() const
+{
+	UWorld* World{ GetGameInstance()->GetWorld() };
+	return World && World->IsGameWorld() ? World : nullptr;
+}
+
+AShooterCharacter* UShooterSaveSubsystem::GetPlayerCharacter() const
+{
+	return Cast<AShooterCharacter>(UGameplayStatics::GetPlayerCharacter(GetGameWorld(), 0));
+}
+
+void UShooterSaveSubsystem::SaveToSlot(const FString& SlotName)
+{
+	if (SlotName.IsEmpty()) return;
+
+	if (IsBusy())
+	{
+		QueuedSaveSlot = SlotName;
+		return;
+	}
+
+	UWorld* World{ GetGameWorld() };
+	if (World == nullptr) return;
+
+	FSnapshotPtr Snapshot{ CaptureSnapshot(World) };
+
+	// Deltas only make sense against a base of the same slot and map that is known to be on disk.
+	FSnapshotPtr Base;
+	const int32 DeltasPerBase{ CVarSaveDeltasPerBase.GetValueOnGameThread() };
+	if (BaseSnapshot.IsValid()
+		&& BaseSlotName == SlotName
+		&& BaseSnapshot->MapName == Snapshot->MapName
+		&& NumDeltasSinceBase < DeltasPerBase)
+	{
+		Base = BaseSnapshot;
+	}
+
+	bSaveInFlight = true;
+	const FGuid DeltaBaseId{ BaseId };
+	const int32 MaxDeltaSize{ BaseSize / 2 };
+	TWeakObjectPtr<UShooterSaveSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SlotName, Snapshot, Base, DeltaBaseId, MaxDeltaSize]()
+	{
+		TArray<uint8> Encoded;
+		bool bDelta{ Base.IsValid() };
+		{
+			FMemoryWriter Writer(Encoded);
+			Snapshot->Encode(Writer, Base.Get());
+		}
+
+		// Once most of the world has changed since the base, a new base is smaller to load.
+		if (bDelta && Encoded.Num() > MaxDeltaSize)
+		{
+			bDelta = false;
+			Encoded.Reset();
+			FMemoryWriter Writer(Encoded);
+			Snapshot->Encode(Writer, nullptr);
+		}
+
+		TArray<uint8> Payload;
+		const bool bCompressed{ UShooterSaveGame::CompressPayload(Encoded, Payload) };
+		const int32 UncompressedSize{ Encoded.Num() };
+		const FGuid WrittenBaseId{ bDelta ? DeltaBaseId : FGuid::NewGuid() };
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, Snapshot, bDelta, bCompressed, WrittenBaseId, UncompressedSize, Payload = MoveTemp(Payload)]() mutable
+		{
+			UShooterSaveSubsystem* This{ WeakThis.Get() };
+			if (This == nullptr) return;
+
+			if (!bCompressed)
+			{
+				UE_LOG(LogSlime, Error, TEXT("Failed to compress save for slot %s"), *SlotName);
+				This->bSaveInFlight = false;
+				return;
+			}
+			This->WriteSave(SlotName, Snapshot, bDelta, WrittenBaseId, UncompressedSize, MoveTemp(Payload));
+		});
+	});
+}
+
+UShooterSaveSubsystem::FSnapshotPtr UShooterSaveSubsystem::CaptureSnapshot(UWorld* World)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveCapture);
+
+	FSnapshotPtr Snapshot{ MakeShared<FShooterSaveSnapshot, ESPMode::ThreadSafe>() };
+	Snapshot->MapName = GetSaveMapName(World);
+
+	if (const AShooterCharacter* Character = GetPlayerCharacter())
+	{
+		Character->CaptureSaveState(Snapshot->Player);
+	}
+
+	// Items still owned by a streamed cell come back from the placement table, so only its consumed records are saved.
+	TSet<const AItem*> StreamedItems;
+	const UItemStreamingSubsystem* Streaming{ World->GetSubsystem<UItemStreamingSubsystem>() };
+	if (Streaming && Streaming->IsStreaming())
+	{
+		Streaming->GetPersistentState(Snapshot->ConsumedRecords, StreamedItems);
+	}
+
+	TArray<AItem*> GroundItems;
+	if (const UItemWorldSubsystem* ItemWorld = World->GetSubsystem<UItemWorldSubsystem>())
+	{
+		ItemWorld->GetGroundItems(GroundItems);
+	}
+
+	TMap<const UClass*, uint16> ClassIndices;
+	Snapshot->Items.Reserve(GroundItems.Num());
+	for (AItem* Item : GroundItems)
+	{
+		if (StreamedItems.Contains(Item)) continue;
+
+		const UClass* ItemClass{ Item->GetClass() };
+		const uint16* ClassIndex{ ClassIndices.Find(ItemClass) };
+		if (ClassIndex == nullptr)
+		{
+			ClassIndex = &ClassIndices.Add(ItemClass, static_cast<uint16>(ItemClassPaths.AddUnique(ItemClass->GetPathName())));
+		}
+
+		if (Item->GetSaveId() == 0)
+		{
+			Item->SetSaveId(NextItemId++);
+		}
+
+		FShooterSavedItem& Saved{ Snapshot->Items.AddDefaulted_GetRef() };
+		Saved.Id = Item->GetSaveId();
+		Saved.ClassIndex = *ClassIndex;
+		Saved.Rarity = static_cast<uint8>(Item->GetItemRarity());
+		Saved.Count = Item->GetItemCount();
+		Saved.Location = Item->GetActorLocation();
+		Saved.Yaw = Item->GetActorRotation().Yaw;
+		if (const AWeapon* Weapon = Cast<AWeapon>(Item))
+		{
+			Saved.SubType = static_cast<uint8>(Weapon->GetWeaponType());
+			Saved.AmmoCount = Weapon->GetAmmo();
+		}
+		else if (const AAmmo* Ammo = Cast<AAmmo>(Item))
+		{
+			Saved.SubType = static_cast<uint8>(Ammo->GetAmmoType());
+		}
+	}
+	Snapshot->ItemClassPaths = ItemClassPaths;
+
+	return Snapshot;
+}
+
+void UShooterSaveSubsystem::WriteSave(const FString& SlotName, FSnapshotPtr Snapshot, bool bDelta, FGuid SaveBaseId, int32 UncompressedSize, TArray<uint8> Payload)
+{
+	UShooterSaveGame* SaveGame{ Cast<UShooterSaveGame>(UGameplayStatics::CreateSaveGameObject(UShooterSaveGame::StaticClass())) };
+	SaveGame->bDelta = bDelta;
+	SaveGame->BaseId = SaveBaseId;
+	SaveGame->UncompressedSize = UncompressedSize;
+	SaveGame->Payload = MoveTemp(Payload);
+
+	// The save object is a byte array, so its serialization here is a copy; the file write happens on a worker thread.
+	UGameplayStatics::AsyncSaveGameToSlot(
+		SaveGame,
+		bDelta ? GetDeltaSlotName(SlotName) : SlotName,
+		0,
+		FAsyncSaveGameToSlotDelegate::CreateUObject(this, &UShooterSaveSubsystem::OnSaveWritten, SlotName, Snapshot, bDelta, SaveBaseId, UncompressedSize));
+}
+
+void UShooterSaveSubsystem::OnSaveWritten(const FString& WrittenSlotName, const int32 UserIndex, bool bSuccess, FString SlotName, FSnapshotPtr Snapshot, bool bDelta, FGuid SaveBaseId, int32 UncompressedSize)
+{
+	bSaveInFlight = false;
+
+	if (!bSuccess)
+	{
+		UE_LOG(LogSlime, Error, TEXT("Failed to write save slot %s"), *WrittenSlotName);
+	}
+	else
+	{
+		UE_LOG(LogSlime, Log, TEXT("Saved %s %s: %d ground items, %d bytes before compression."),
+			bDelta ? TEXT("delta") : TEXT("base"),
+			*WrittenSlotName,
+			Snapshot->Items.Num(),
+			UncompressedSize);
+
+		if (bDelta)
+		{
+			++NumDeltasSinceBase;
+		}
+		else
+		{
+			// The old delta names a different base id now, so it is never applied to this one.
+			BaseSnapshot = Snapshot;
+			BaseSlotName = SlotName;
+			BaseId = SaveBaseId;
+			BaseSize = UncompressedSize;
+			NumDeltasSinceBase = 0;
+		}
+	}
+
+	if (!QueuedSaveSlot.IsEmpty() && !IsBusy())
+	{
+		const FString NextSlotName{ MoveTemp(QueuedSaveSlot) };
+		QueuedSaveSlot.Reset();
+		SaveToSlot(NextSlotName);
+	}
+}
+
+void UShooterSaveSubsystem::LoadFromSlot(const FString& SlotName)
+{
+	if (SlotName.IsEmpty()) return;
+
+	if (IsBusy())
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Can't load %s while a save or load is in progress."), *SlotName);
+		return;
+	}
+
+	bLoadInFlight = true;
+	UGameplayStatics::AsyncLoadGameFromSlot(
+		SlotName,
+		0,
+		FAsyncLoadGameFromSlotDelegate::CreateUObject(this, &UShooterSaveSubsystem::OnBaseLoaded, SlotName));
+}
+
+void UShooterSaveSubsystem::OnBaseLoaded(const FString& LoadedSlotName, const int32 UserIndex, USaveGame* SaveGame, FString SlotName)
+{
+	UShooterSaveGame* Base{ Cast<UShooterSaveGame>(SaveGame) };
+	if (Base == nullptr || Base->bDelta || Base->FormatVersion != UShooterSaveGame::FORMAT_VERSION)
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Save slot %s is missing or unreadable."), *LoadedSlotName);
+		bLoadInFlight = false;
+		return;
+	}
+
+	LoadedBase = Base;
+	UGameplayStatics::AsyncLoadGameFromSlot(
+		GetDeltaSlotName(SlotName),
+		0,
+		FAsyncLoadGameFromSlotDelegate::CreateUObject(this, &UShooterSaveSubsystem::OnDeltaLoaded, SlotName));
+}
+
+void UShooterSaveSubsystem::OnDeltaLoaded(const FString& LoadedSlotName, const int32 UserIndex, USaveGame* SaveGame, FString SlotName)
+{
+	UShooterSaveGame* Base{ LoadedBase };
+	LoadedBase = nullptr;
+	if (Base == nullptr)
+	{
+		bLoadInFlight = false;
+		return;
+	}
+
+	// A delta written against an older base is stale, and the base alone is the latest state.
+	const UShooterSaveGame* Delta{ Cast<UShooterSaveGame>(SaveGame) };
+	const bool bHasDelta{ Delta
+		&& Delta->bDelta
+		&& Delta->FormatVersion == UShooterSaveGame::FORMAT_VERSION
+		&& Delta->BaseId == Base->BaseId };
+
+	// Copied, so the save objects can go, and the worker never touches a UObject.
+	TArray<uint8> BasePayload{ Base->Payload };
+	TArray<uint8> DeltaPayload;
+	int32 DeltaSize{ 0 };
+	if (bHasDelta)
+	{
+		DeltaPayload = Delta->Payload;
+		DeltaSize = Delta->UncompressedSize;
+	}
+	const int32 BaseUncompressedSize{ Base->UncompressedSize };
+	const FGuid LoadedBaseId{ Base->BaseId };
+
+	TWeakObjectPtr<UShooterSaveSubsystem> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SlotName, bHasDelta, LoadedBaseId, BaseUncompressedSize, DeltaSize, BasePayload = MoveTemp(BasePayload), DeltaPayload = MoveTemp(DeltaPayload)]()
+	{
+		FSnapshotPtr DecodedBase{ MakeShared<FShooterSaveSnapshot, ESPMode::ThreadSafe>() };
+		FSnapshotPtr Restored;
+
+		TArray<uint8> Encoded;
+		if (UShooterSaveGame::DecompressPayload(BasePayload, BaseUncompressedSize, Encoded))
+		{
+			FMemoryReader Reader(Encoded);
+			if (DecodedBase->Decode(Reader, nullptr))
+			{
+				Restored = DecodedBase;
+			}
+		}
+
+		if (Restored.IsValid() && bHasDelta)
+		{
+			FSnapshotPtr Merged{ MakeShared<FShooterSaveSnapshot, ESPMode::ThreadSafe>() };
+			if (UShooterSaveGame::DecompressPayload(DeltaPayload, DeltaSize, Encoded))
+			{
+				FMemoryReader Reader(Encoded);
+				if (Merged->Decode(Reader, DecodedBase.Get()))
+				{
+					Restored = Merged;
+				}
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, DecodedBase, LoadedBaseId, BaseUncompressedSize, bHasDelta, Restored]()
+		{
+			if (UShooterSaveSubsystem* This = WeakThis.Get())
+			{
+				This->BeginRestore(SlotName, DecodedBase, LoadedBaseId, BaseUncompressedSize, bHasDelta && Restored != DecodedBase, Restored);
+			}
+		});
+	});
+}
+
+void UShooterSaveSubsystem::BeginRestore(const FString& SlotName, FSnapshotPtr Base, FGuid LoadedBaseId, int32 LoadedBaseSize, bool bHadDelta, FSnapshotPtr Restored)
+{
+	bLoadInFlight = false;
+
+	UWorld* World{ GetGameWorld() };
+	if (!Restored.IsValid() || World == nullptr)
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Save slot %s could not be decoded."), *SlotName);
+		return;
+	}
+
+	// Later saves to this slot are deltas against the base that was just loaded.
+	BaseSnapshot = Base;
+	BaseSlotName = SlotName;
+	BaseId = LoadedBaseId;
+	BaseSize = LoadedBaseSize;
+	NumDeltasSinceBase = bHadDelta ? 1 : 0;
+	ItemClassPaths = Restored->ItemClassPaths;
+	for (const FShooterSavedItem& Saved : Restored->Items)
+	{
+		NextItemId = FMath::Max(NextItemId, Saved.Id + 1);
+	}
+
+	AShooterCharacter* Character{ GetPlayerCharacter() };
+	if (Character)
+	{
+		Character->RestoreSaveState(Restored->Player);
+	}
+
+	if (Restored->MapName != GetSaveMapName(World))
+	{
+		UE_LOG(LogSlime, Warning, TEXT("Save slot %s is of map %s, so only the player was restored."), *SlotName, *Restored->MapName);
+		return;
+	}
+
+	if (UItemStreamingSubsystem* Streaming = World->GetSubsystem<UItemStreamingSubsystem>())
+	{
+		if (Streaming->IsStreaming() && Restored->ConsumedRecords.Num() > 0)
+		{
+			Streaming->RestorePersistentState(Restored->ConsumedRecords);
+		}
+	}
+
+	// Streamed items were released above, so whatever else lies on the ground is replaced by the saved items.
+	TArray<AItem*> GroundItems;
+	if (const UItemWorldSubsystem* ItemWorld = World->GetSubsystem<UItemWorldSubsystem>())
+	{
+		ItemWorld->GetGroundItems(GroundItems);
+	}
+	ItemsToDestroy.Reset(GroundItems.Num());
+	for (AItem* Item : GroundItems)
+	{
+		ItemsToDestroy.Add(Item);
+	}
+
+	RestoreClasses.Reset(Restored->ItemClassPaths.Num());
+	for (const FString& ClassPath : Restored->ItemClassPaths)
+	{
+		UClass* ItemClass{ StaticLoadClass(AItem::StaticClass(), nullptr, *ClassPath) };
+		if (ItemClass == nullptr)
+		{
+			UE_LOG(LogSlime, Warning, TEXT("Saved item class %s failed to load, its items are skipped."), *ClassPath);
+		}
+		RestoreClasses.Add(ItemClass);
+	}
+
+	ItemsToRestore = Restored->Items;
+	if (Character)
+	{
+		// Farthest first, so the nearest item pops off the end.
+		const FVector PlayerLocation{ Character->GetActorLocation() };
+		ItemsToRestore.Sort([&PlayerLocation](const FShooterSavedItem& A, const FShooterSavedItem& B)
+		{
+			return FVector::DistSquared(A.Location, PlayerLocation) > FVector::DistSquared(B.Location, PlayerLocation);
+		});
+	}
+
+	NumRestoredItems = 0;
+	NumRestoreFrames = 0;
+	RestoreStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterSaveSubsystem::Tick(float DeltaTime)
+{
+	RestorePendingItems();
+}
+
+void UShooterSaveSubsystem::RestorePendingItems()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveRestoreItems);
+
+	RunWithinFrameBudget(FPlatformTime::Seconds(), CVarSaveRestoreBudgetMs.GetValueOnGameThread(),
+		[this]() { return ItemsToDestroy.Num() > 0 || ItemsToRestore.Num() > 0; },
+		[this]()
+		{
+			if (ItemsToDestroy.Num() > 0)
+			{
+				if (AItem* Item = ItemsToDestroy.Pop(false).Get())
+				{
+					Item->Destroy();
+				}
+				return;
+			}
+
+			if (SpawnSavedItem(ItemsToRestore.Pop(false)) != nullptr)
+			{
+				++NumRestoredItems;
+			}
+		});
+
+	++NumRestoreFrames;
+	if (ItemsToDestroy.Num() == 0 && ItemsToRestore.Num() == 0)
+	{
+		RestoreClasses.Reset();
+		UE_LOG(LogSlime, Log, TEXT("Restored %d ground items over %d frames, %.2f ms wall time."),
+			NumRestoredItems,
+			NumRestoreFrames,
+			(FPlatformTime::Seconds() - RestoreStartTime) * 1000.0);
+
+		if (!QueuedSaveSlot.IsEmpty())
+		{
+			const FString NextSlotName{ MoveTemp(QueuedSaveSlot) };
+			QueuedSaveSlot.Reset();
+			SaveToSlot(NextSlotName);
+		}
+	}
+}
+
+AItem* UShooterSaveSubsystem::SpawnSavedItem(const FShooterSavedItem& Saved)
+{
+	UClass* ItemClass{ RestoreClasses.IsValidIndex(Saved.ClassIndex) ? RestoreClasses[Saved.ClassIndex] : nullptr };
+	UWorld* World{ GetGameWorld() };
+	if (ItemClass == nullptr || World == nullptr) return nullptr;
+
+	const FTransform SpawnTransform{ FRotator(0.f, Saved.Yaw, 0.f), Saved.Location };
+
+	FItemSpawnParams Params;
+	Params.Rarity = static_cast<EItemRarity>(Saved.Rarity);
+	Params.ItemCount = Saved.Count;
+	Params.SubType = Saved.SubType;
+	Params.SaveId = Saved.Id;
+	Params.bDeferActivation = true;
+	AItem* Item{ AItem::SpawnItem(World, ItemClass, SpawnTransform, Params) };
+
+	if (AWeapon* Weapon = Cast<AWeapon>(Item))
+	{
+		FWeaponInstanceRecord Record{ Weapon->MakeInstanceRecord() };
+		Record.AmmoCount = Saved.AmmoCount;
+		Weapon->ApplyInstanceRecord(Record);
+	}
+	return Item;
+}
+
+bool UShooterSaveSubsystem::IsTickable() const
+{
+	return !IsTemplate() && (ItemsToDestroy.Num() > 0 || ItemsToRestore.Num() > 0);
+}
+
+TStatId UShooterSaveSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSaveSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UShooterSaveSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetGameWorld();
+}
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "ShooterSaveGame.h"
+#include "ShooterSaveSubsystem.generated.h"
+
+class AItem;
+class AShooterCharacter;
+class USaveGame;
+
+/**
+ * Saves and restores the player's inventory and ammo, and every item lying on the ground.
+ *
+ * Saving copies the state on the game thread, then encodes and compresses it on a worker thread and writes it with
+ * AsyncSaveGameToSlot. The first save to a slot writes a whole snapshot (the base); later ones write only what changed
+ * since the base to <Slot>_Delta, until slime.Save.DeltasPerBase deltas have been written or a delta grows past half
+ * the base, and a new base is written instead.
+ *
+ * Loading reads and decodes both slots in the background, restores the player at once, and then replaces the ground
+ * items a few per frame under slime.Save.RestoreBudgetMs. Items streamed from the map's placement table are restored
+ * by telling the UItemStreamingSubsystem which of its records are gone.
+ */
+UCLASS()
+class SLIME_API UShooterSaveSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Writes the current state to the slot in the background. A save requested while busy runs once it is done. */
+	UFUNCTION(BlueprintCallable, Category = Save)
+	void SaveToSlot(const FString& SlotName);
+
+	/** Loads the slot in the background and restores it over the following frames. */
+	UFUNCTION(BlueprintCallable, Category = Save)
+	void LoadFromSlot(const FString& SlotName);
+
+	/** True while a save or load is in flight, or items are still being restored. */
+	UFUNCTION(BlueprintPure, Category = Save)
+	bool IsBusy() const;
+
+	static FString GetDeltaSlotName(const FString& SlotName);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+	virtual void Deinitialize() override;
+
+private:
+	typedef TSharedPtr<FShooterSaveSnapshot, ESPMode::ThreadSafe> FSnapshotPtr;
+
+	UWorld* GetGameWorld() const;
+	AShooterCharacter* GetPlayerCharacter() const;
+
+	/** Copies the state to save. Only reads values, so it is cheap even with thousands of ground items. */
+	FSnapshotPtr CaptureSnapshot(UWorld* World);
+
+	/** Called on the game thread with the encoded snapshot, to write it to its slot. */
+	void WriteSave(const FString& SlotName, FSnapshotPtr Snapshot, bool bDelta, FGuid SaveBaseId, int32 UncompressedSize, TArray<uint8> Payload);
+	void OnSaveWritten(const FString& WrittenSlotName, const int32 UserIndex, bool bSuccess, FString SlotName, FSnapshotPtr Snapshot, bool bDelta, FGuid SaveBaseId, int32 UncompressedSize);
+
+	void OnBaseLoaded(const FString& LoadedSlotName, const int32 UserIndex, USaveGame* SaveGame, FString SlotName);
+	void OnDeltaLoaded(const FString& LoadedSlotName, const int32 UserIndex, USaveGame* SaveGame, FString SlotName);
+
+	/** Called on the game thread with the decoded base and the state to restore, which is the base plus its delta. */
+	void BeginRestore(const FString& SlotName, FSnapshotPtr Base, FGuid LoadedBaseId, int32 LoadedBaseSize, bool bHadDelta, FSnapshotPtr Restored);
+
+	/** Destroys replaced ground items, then spawns saved ones, until this frame's budget is spent. */
+	void RestorePendingItems();
+	AItem* SpawnSavedItem(const FShooterSavedItem& Saved);
+
+	/** The base that deltas are written against: the last one written or loaded. */
+	FSnapshotPtr BaseSnapshot;
+	FString BaseSlotName;
+	FGuid BaseId;
+	/** Uncompressed size of the base. A delta bigger than half of it is written as a new base instead. */
+	int32 BaseSize{ 0 };
+	int32 NumDeltasSinceBase{ 0 };
+
+	/** Class paths of saved items, see FShooterSaveSnapshot::ItemClassPaths. */
+	TArray<FString> ItemClassPaths;
+	uint32 NextItemId{ 1 };
+
+	bool bSaveInFlight{ false };
+	bool bLoadInFlight{ false };
+
+	/** Slot of a save requested while busy. */
+	FString QueuedSaveSlot;
+
+	/** Base read by LoadFromSlot(), held while its delta is read. */
+	UPROPERTY(Transient)
+	UShooterSaveGame* LoadedBase{ nullptr };
+
+	/** Classes of the items being restored, by class index. */
+	UPROPERTY(Transient)
+	TArray<UClass*> RestoreClasses;
+
+	/** Ground items the restore replaces. */
+	TArray<TWeakObjectPtr<AItem>> ItemsToDestroy;
+
+	/** Items left to spawn, nearest to the player last. */
+	TArray<FShooterSavedItem> ItemsToRestore;
+
+	int32 NumRestoredItems{ 0 };
+	int32 NumRestoreFrames{ 0 };
+	double RestoreStartTime{ 0.0 };
+};
@@ -0,0 +1,485 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterSignificanceSubsystem.h"
+
+#include "ShooterCharacter.h"
+#include "ShooterCrowdAnimationSubsystem.h"
+#include "Item.h"
+#include "ItemWorldSubsystem.h"
+#include "Slime.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_SignificanceUpdate, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Characters High"), STAT_SignificanceCharactersHigh, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Characters Medium"), STAT_SignificanceCharactersMedium, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Characters Low"), STAT_SignificanceCharactersLow, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Characters Dormant"), STAT_SignificanceCharactersDormant, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Items High"), STAT_SignificanceItemsHigh, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Items Medium"), STAT_SignificanceItemsMedium, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Items Low"), STAT_SignificanceItemsLow, STATGROUP_Slime);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Items Dormant"), STAT_SignificanceItemsDormant, STATGROUP_Slime);
+
+static TAutoConsoleVariable<int32> CVarSignificanceEnabled(
+	TEXT("slime.Significance.Enabled"),
+	1,
+	TEXT("1: characters and ground items tick less the less significant they are. 0: everything ticks at full rate."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceUpdateInterval(
+	TEXT("slime.Significance.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between significance updates."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceHighDistance(
+	TEXT("slime.Significance.HighDistance"),
+	1500.f,
+	TEXT("Objects nearer than this to a player viewpoint are highly significant."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceMediumDistance(
+	TEXT("slime.Significance.MediumDistance"),
+	4000.f,
+	TEXT("Objects nearer than this, and not highly significant, are of medium significance."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceLowDistance(
+	TEXT("slime.Significance.LowDistance"),
+	8000.f,
+	TEXT("Objects nearer than this, and not of medium significance, are of low significance. Anything farther is dormant."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceHysteresis(
+	TEXT("slime.Significance.Hysteresis"),
+	0.1f,
+	TEXT("Fraction of a band's edge distance an object has to cross it by before it changes band."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceHiddenDistanceScale(
+	TEXT("slime.Significance.HiddenDistanceScale"),
+	2.f,
+	TEXT("Objects not rendered lately count as this many times farther away."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceAnimationBudget(
+	TEXT("slime.Significance.AnimationBudget"),
+	1,
+	TEXT("1: character meshes are ticked by the animation budget allocator (budget set by a.Budget.BudgetMs), fed significance from here. 0: by their significance band."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld SignificanceDumpCommand(
+	TEXT("slime.Significance.Dump"),
+	TEXT("Logs how many characters and ground items are in each significance band, and the band of each."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterSignificanceSubsystem* Significance = World ? World->GetSubsystem<UShooterSignificanceSubsystem>() : nullptr)
+		{
+			Significance->Dump();
+		}
+	}));
+
+namespace
+{
+	constexpr int32 NumBands{ static_cast<int32>(EShooterSignificance::MAX) };
+
+	/** Seconds between ticks in each band; 0 is every frame. */
+	constexpr float CharacterTickIntervals[NumBands]{ 0.f, 1.f / 30.f, 0.1f, 0.25f };
+	constexpr float MovementTickIntervals[NumBands]{ 0.f, 0.f, 1.f / 20.f, 0.1f };
+	constexpr float MeshTickIntervals[NumBands]{ 0.f, 1.f / 30.f, 0.1f, 0.25f };
+	constexpr float ItemTickIntervals[NumBands]{ 0.f, 1.f / 20.f, 0.2f, 0.5f };
+
+	/** Pose and bone refresh of each band's meshes while they aren't rendered. */
+	constexpr EVisibilityBasedAnimTickOption MeshTickOptions[NumBands]{
+		EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones,
+		EVisibilityBasedAnimTickOption::AlwaysTickPose,
+		EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered,
+		EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered };
+
+	/** Seconds since an actor was last rendered for it to still count as visible. */
+	constexpr float RecentlyRenderedTolerance{ 0.5f };
+
+	FORCEINLINE EShooterSignificance BandForDistance(float Distance)
+	{
+		if (Distance < CVarSignificanceHighDistance.GetValueOnGameThread()) return EShooterSignificance::High;
+		if (Distance < CVarSignificanceMediumDistance.GetValueOnGameThread()) return EShooterSignificance::Medium;
+		if (Distance < CVarSignificanceLowDistance.GetValueOnGameThread()) return EShooterSignificance::Low;
+		return EShooterSignificance::Dormant;
+	}
+
+	FORCEINLINE EShooterSignificance ClampBand(EShooterSignificance Band, EShooterSignificance MostSignificant, EShooterSignificance LeastSignificant)
+	{
+		return static_cast<EShooterSignificance>(FMath::Clamp(
+			static_cast<int32>(Band), static_cast<int32>(MostSignificant), static_cast<int32>(LeastSignificant)));
+	}
+}
+
+void UShooterSignificanceSubsystem::RegisterCharacter(AShooterCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UShooterSignificanceSubsystem::UnregisterCharacter(AShooterCharacter* Character)
+{
+	Characters.RemoveSwap(Character);
+	Entries.Remove(Character);
+	if (UShooterCrowdAnimationSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>())
+	{
+		Crowd->SetShared(Character, false, 0.f);
+	}
+}
+
+bool UShooterSignificanceSubsystem::IsAnimationBudgetEnabled()
+{
+	return CVarSignificanceAnimationBudget.GetValueOnGameThread() != 0;
+}
+
+bool UShooterSignificanceSubsystem::CanShareAnimation(const AShooterCharacter* Character)
+{
+	// The crowd states have no firing or equipping pose, and those are protected from the animation budget.
+	const ECombatState CombatState{ Character->GetCombatState() };
+	return CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Reloading;
+}
+
+void UShooterSignificanceSubsystem::RefreshAnimationBudget(AShooterCharacter* Character)
+{
+	// A bot that starts firing or equipping gets its own anim instance back now, not at the next update.
+	if (!CanShareAnimation(Character))
+	{
+		if (UShooterCrowdAnimationSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>())
+		{
+			Crowd->SetShared(Character, false, 0.f);
+		}
+	}
+
+	if (!bAnimationBudget) return;
+
+	if (const FSignificanceEntry* Entry = Entries.Find(Character))
+	{
+		ApplyAnimationBudget(Character, Entry->AnimationSignificance);
+	}
+}
+
+const TCHAR* UShooterSignificanceSubsystem::GetBandName(EShooterSignificance Band)
+{
+	switch (Band)
+	{
+	case EShooterSignificance::High: return TEXT("High");
+	case EShooterSignificance::Medium: return TEXT("Medium");
+	case EShooterSignificance::Low: return TEXT("Low");
+	case EShooterSignificance::Dormant: return TEXT("Dormant");
+	default: return TEXT("?");
+	}
+}
+
+void UShooterSignificanceSubsystem::Dump() const
+{
+	UE_LOG(LogSlime, Display, TEXT("Significance (%s):"), bWasEnabled ? TEXT("enabled") : TEXT("disabled"));
+	for (int32 Band = 0; Band < NumBands; ++Band)
+	{
+		UE_LOG(LogSlime, Display, TEXT("  %-8s characters %4d, items %4d"),
+			GetBandName(static_cast<EShooterSignificance>(Band)), NumCharacters[Band], NumItems[Band]);
+	}
+	if (const UShooterCrowdAnimationSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>())
+	{
+		UE_LOG(LogSlime, Display, TEXT("  %d characters share crowd animation"), Crowd->GetNumShared());
+	}
+	for (const TPair<TWeakObjectPtr<AActor>, FSignificanceEntry>& Entry : Entries)
+	{
+		if (const AActor* Actor = Entry.Key.Get())
+		{
+			UE_LOG(LogSlime, Display, TEXT("  %s: %s"), *Actor->GetName(), GetBandName(Entry.Value.Band));
+		}
+	}
+}
+
+void UShooterSignificanceSubsystem::Tick(float DeltaTime)
+{
+	const bool bEnabled{ CVarSignificanceEnabled.GetValueOnGameThread() != 0 };
+	const bool bBudget{ bEnabled && IsAnimationBudgetEnabled() };
+	if (!bAnimationBudgetSynced || bBudget != bAnimationBudget)
+	{
+		// Hand the meshes over with their settings restored; the next update re-applies everything in the new mode.
+		RestoreAll();
+		bAnimationBudget = bBudget;
+		SyncAnimationBudget();
+		bAnimationBudgetSynced = true;
+	}
+
+	if (!bEnabled)
+	{
+		if (bWasEnabled)
+		{
+			RestoreAll();
+			bWasEnabled = false;
+		}
+		return;
+	}
+	bWasEnabled = true;
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < CVarSignificanceUpdateInterval.GetValueOnGameThread()) return;
+	TimeSinceUpdate = 0.f;
+
+	UpdateSignificance();
+}
+
+bool UShooterSignificanceSubsystem::IsTickable() const
+{
+	return !IsTemplate();
+}
+
+TStatId UShooterSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterSignificanceSubsystem::Deinitialize()
+{
+	Characters.Empty();
+	Entries.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterSignificanceSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SignificanceUpdate);
+
+	++UpdateCount;
+	FMemory::Memzero(NumCharacters);
+	FMemory::Memzero(NumItems);
+
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Emplace(Rotation, Location);
+		}
+	}
+
+	UShooterCrowdAnimationSubsystem* Crowd{ GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>() };
+	const float HighDistance{ FMath::Max(CVarSignificanceHighDistance.GetValueOnGameThread(), 1.f) };
+	for (AShooterCharacter* Character : Characters)
+	{
+		// The local player's own character always runs at full rate; other players, and bots mid-fight or mid-reload,
+		// are never dormant.
+		EShooterSignificance MostSignificant{ EShooterSignificance::High };
+		EShooterSignificance LeastSignificant{ EShooterSignificance::Dormant };
+		if (Character->IsLocallyControlled())
+		{
+			LeastSignificant = EShooterSignificance::High;
+		}
+		else if (Character->IsPlayerControlled() || Character->GetCombatState() != ECombatState::ECS_Unoccupied)
+		{
+			LeastSignificant = EShooterSignificance::Low;
+		}
+
+		const float Distance{ GetEffectiveDistance(Character) };
+		const EShooterSignificance Band{ UpdateEntry(Character, Distance, MostSignificant, LeastSignificant) };
+		++NumCharacters[static_cast<int32>(Band)];
+
+		// 1 within the high band, falling off with distance beyond it.
+		FSignificanceEntry& Entry{ Entries.FindChecked(Character) };
+		Entry.AnimationSignificance = Character->IsLocallyControlled() ? 1.f : HighDistance / FMath::Max(Distance, HighDistance);
+		if (bAnimationBudget)
+		{
+			ApplyAnimationBudget(Character, Entry.AnimationSignificance);
+		}
+
+		// Distant bots copy shared leader poses; players and nearer characters keep their own anim instance.
+		if (Crowd)
+		{
+			const bool bShared{ !Character->IsPlayerControlled() && Band >= EShooterSignificance::Low && CanShareAnimation(Character) };
+			Crowd->SetShared(Character, bShared, Entry.AnimationSignificance);
+		}
+	}
+	if (Crowd)
+	{
+		Crowd->UpdateSignificance(Viewpoints);
+	}
+
+	// Only items lying on the ground are banded. The rest are falling, flying to a player or held, and run at full rate;
+	// AItem resets its tick interval when it leaves the ground.
+	if (const UItemWorldSubsystem* ItemSubsystem = GetWorld()->GetSubsystem<UItemWorldSubsystem>())
+	{
+		TArray<AItem*> GroundItems;
+		ItemSubsystem->GetGroundItems(GroundItems);
+		for (AItem* Item : GroundItems)
+		{
+			const EShooterSignificance Band{ UpdateEntry(Item, GetEffectiveDistance(Item), EShooterSignificance::High, EShooterSignificance::Dormant) };
+			++NumItems[static_cast<int32>(Band)];
+		}
+	}
+
+	// Forget objects that weren't seen this update; they left the ground or ended play.
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().LastUpdate != UpdateCount)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SignificanceCharactersHigh, NumCharacters[0]);
+	SET_DWORD_STAT(STAT_SignificanceCharactersMedium, NumCharacters[1]);
+	SET_DWORD_STAT(STAT_SignificanceCharactersLow, NumCharacters[2]);
+	SET_DWORD_STAT(STAT_SignificanceCharactersDormant, NumCharacters[3]);
+	SET_DWORD_STAT(STAT_SignificanceItemsHigh, NumItems[0]);
+	SET_DWORD_STAT(STAT_SignificanceItemsMedium, NumItems[1]);
+	SET_DWORD_STAT(STAT_SignificanceItemsLow, NumItems[2]);
+	SET_DWORD_STAT(STAT_SignificanceItemsDormant, NumItems[3]);
+}
+
+float UShooterSignificanceSubsystem::GetEffectiveDistance(const AActor* Actor) const
+{
+	if (Viewpoints.Num() == 0) return 0.f;
+
+	const FVector Location{ Actor->GetActorLocation() };
+	float DistanceSquared{ TNumericLimits<float>::Max() };
+	for (const FTransform& Viewpoint : Viewpoints)
+	{
+		DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(Location, Viewpoint.GetLocation()));
+	}
+
+	const float Distance{ FMath::Sqrt(DistanceSquared) };
+	return Actor->WasRecentlyRendered(RecentlyRenderedTolerance)
+		? Distance
+		: Distance * CVarSignificanceHiddenDistanceScale.GetValueOnGameThread();
+}
+
+EShooterSignificance UShooterSignificanceSubsystem::GetBand(EShooterSignificance Current, float Distance, bool bTracked)
+{
+	if (!bTracked) return BandForDistance(Distance);
+
+	// Bands with their edges pushed out, and pulled in, by the hysteresis margin.
+	const float Hysteresis{ FMath::Clamp(CVarSignificanceHysteresis.GetValueOnGameThread(), 0.f, 0.9f) };
+	const EShooterSignificance Farther{ BandForDistance(Distance / (1.f + Hysteresis)) };
+	if (Farther > Current) return Farther;
+
+	const EShooterSignificance Nearer{ BandForDistance(Distance / (1.f - Hysteresis)) };
+	if (Nearer < Current) return Nearer;
+
+	return Current;
+}
+
+EShooterSignificance UShooterSignificanceSubsystem::UpdateEntry(AActor* Actor, float Distance, EShooterSignificance MostSignificantAllowed, EShooterSignificance LeastSignificantAllowed)
+{
+	FSignificanceEntry* Entry{ Entries.Find(Actor) };
+	const bool bTracked{ Entry != nullptr };
+	if (Entry == nullptr)
+	{
+		Entry = &Entries.Add(Actor);
+	}
+
+	const EShooterSignificance Band{ ClampBand(GetBand(Entry->Band, Distance, bTracked), MostSignificantAllowed, LeastSignificantAllowed) };
+	if (!bTracked || Band != Entry->Band)
+	{
+		if (AShooterCharacter* Character = Cast<AShooterCharacter>(Actor))
+		{
+			ApplyCharacterBand(Character, Band, bAnimationBudget);
+		}
+		else
+		{
+			ApplyItemBand(Actor, Band);
+		}
+		Entry->Band = Band;
+	}
+	Entry->LastUpdate = UpdateCount;
+	return Band;
+}
+
+void UShooterSignificanceSubsystem::ApplyCharacterBand(AShooterCharacter* Character, EShooterSignificance Band, bool bBudgetedMesh)
+{
+	const int32 Index{ static_cast<int32>(Band) };
+	Character->SetActorTickInterval(CharacterTickIntervals[Index]);
+
+	// Players' movement is driven by their moves, not by the component's tick; only bots are slowed.
+	if (!Character->IsPlayerControlled())
+	{
+		Character->GetCharacterMovement()->SetComponentTickInterval(MovementTickIntervals[Index]);
+	}
+
+	// The mesh carries the UShooterAnimInstance, so this sets how often the animation updates too.
+	// Budgeted meshes are ticked by the animation budget allocator instead.
+	if (!bBudgetedMesh)
+	{
+		USkeletalMeshComponent* Mesh{ Character->GetMesh() };
+		Mesh->SetComponentTickInterval(MeshTickIntervals[Index]);
+		Mesh->VisibilityBasedAnimTickOption = MeshTickOptions[Index];
+	}
+}
+
+void UShooterSignificanceSubsystem::ApplyAnimationBudget(AShooterCharacter* Character, float AnimationSignificance) const
+{
+	IAnimationBudgetAllocator* Budget{ IAnimationBudgetAllocator::Get(GetWorld()) };
+	USkeletalMeshComponentBudgeted* Mesh{ Cast<USkeletalMeshComponentBudgeted>(Character->GetMesh()) };
+	if (Budget == nullptr || Mesh == nullptr) return;
+
+	// The local player's own character, and characters firing, reloading or equipping, are never skipped or reduced.
+	const bool bProtected{ Character->IsLocallyControlled() || Character->GetCombatState() != ECombatState::ECS_Unoccupied };
+	Budget->SetComponentSignificance(Mesh, AnimationSignificance, bProtected, false, !bProtected);
+}
+
+void UShooterSignificanceSubsystem::SyncAnimationBudget()
+{
+	IAnimationBudgetAllocator* Budget{ IAnimationBudgetAllocator::Get(GetWorld()) };
+	if (Budget == nullptr) return;
+
+	Budget->SetEnabled(bAnimationBudget);
+	if (!bAnimationBudget) return;
+
+	// Meshes that began play while the allocator was off never registered. Registering twice is harmless. Shared
+	// meshes are ticked by the animation sharing manager, and rejoin the allocator when they are unshared.
+	const UShooterCrowdAnimationSubsystem* Crowd{ GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>() };
+	for (AShooterCharacter* Character : Characters)
+	{
+		if (Crowd && Crowd->IsShared(Character)) continue;
+
+		if (USkeletalMeshComponentBudgeted* Mesh = Cast<USkeletalMeshComponentBudgeted>(Character->GetMesh()))
+		{
+			Budget->RegisterComponent(Mesh);
+		}
+	}
+}
+
+void UShooterSignificanceSubsystem::ApplyItemBand(AActor* Item, EShooterSignificance Band)
+{
+	Item->SetActorTickInterval(ItemTickIntervals[static_cast<int32>(Band)]);
+}
+
+void UShooterSignificanceSubsystem::RestoreAll()
+{
+	for (const TPair<TWeakObjectPtr<AActor>, FSignificanceEntry>& Entry : Entries)
+	{
+		if (AActor* Actor = Entry.Key.Get())
+		{
+			if (AShooterCharacter* Character = Cast<AShooterCharacter>(Actor))
+			{
+				ApplyCharacterBand(Character, EShooterSignificance::High, bAnimationBudget);
+			}
+			else
+			{
+				ApplyItemBand(Actor, EShooterSignificance::High);
+			}
+		}
+	}
+	if (UShooterCrowdAnimationSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdAnimationSubsystem>())
+	{
+		for (AShooterCharacter* Character : Characters)
+		{
+			Crowd->SetShared(Character, false, 0.f);
+		}
+	}
+	Entries.Empty();
+	FMemory::Memzero(NumCharacters);
+	FMemory::Memzero(NumItems);
+}
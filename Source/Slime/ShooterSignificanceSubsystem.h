@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterSignificanceSubsystem.generated.h"
+
+class AShooterCharacter;
+
+/** Significance bands, most significant first. Each band has its own tick intervals and mesh update settings. */
+enum class EShooterSignificance : uint8
+{
+	High,
+	Medium,
+	Low,
+	Dormant,
+
+	MAX
+};
+
+/**
+ * Sorts shooter characters (with their meshes and anim instances) and ground items into significance bands by their
+ * distance to the nearest player viewpoint, whether they were rendered lately and their gameplay relevance, and slows
+ * the ticks of the less significant ones. An object only moves to a farther band once it is slime.Significance.Hysteresis
+ * past the band's edge, and back once it is as far inside, so objects near an edge don't flip every update.
+ * Bands are recomputed every slime.Significance.UpdateInterval seconds; settings are only touched on a band change.
+ *
+ * While slime.Significance.AnimationBudget is on, character meshes are left to the engine's animation budget allocator
+ * instead: their mesh tick settings aren't touched, and each update hands the allocator a continuous significance from
+ * the same effective distance. Characters firing, reloading or equipping are never skipped or reduced.
+ *
+ * Bots in the low and dormant bands are handed to UShooterCrowdAnimationSubsystem to share leader poses.
+ */
+UCLASS()
+class SLIME_API UShooterSignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterCharacter(AShooterCharacter* Character);
+	void UnregisterCharacter(AShooterCharacter* Character);
+
+	/**
+	 * Re-sends Character's significance and protection to the animation budget allocator, and unshares its animation if
+	 * it may no longer be shared. Called on a combat state change.
+	 */
+	void RefreshAnimationBudget(AShooterCharacter* Character);
+
+	/** True if Character's combat state has a shared crowd pose: unoccupied or reloading. */
+	static bool CanShareAnimation(const AShooterCharacter* Character);
+
+	/** Reads slime.Significance.AnimationBudget. */
+	static bool IsAnimationBudgetEnabled();
+
+	/** Number of characters and ground items in each band as of the last update. */
+	FORCEINLINE int32 GetNumCharacters(EShooterSignificance Band) const { return NumCharacters[static_cast<int32>(Band)]; }
+	FORCEINLINE int32 GetNumItems(EShooterSignificance Band) const { return NumItems[static_cast<int32>(Band)]; }
+
+	/** Logs the band counts and the band of every tracked object. */
+	void Dump() const;
+
+	static const TCHAR* GetBandName(EShooterSignificance Band);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+protected:
+	virtual void Deinitialize() override;
+
+private:
+	struct FSignificanceEntry
+	{
+		EShooterSignificance Band{ EShooterSignificance::High };
+		/** Update this entry was last seen in; entries not seen in the latest update are dropped. */
+		uint32 LastUpdate{ 0 };
+		/** Significance handed to the animation budget allocator, higher is more significant. */
+		float AnimationSignificance{ 1.f };
+	};
+
+	/** Recomputes every band, and applies the ones that changed. */
+	void UpdateSignificance();
+
+	/** Distance from the nearest viewpoint, scaled up if the actor hasn't been rendered lately. */
+	float GetEffectiveDistance(const AActor* Actor) const;
+
+	/** The band for Distance, moving away from Current only once past the hysteresis margin. */
+	static EShooterSignificance GetBand(EShooterSignificance Current, float Distance, bool bTracked);
+
+	/** Updates Actor's entry with the band, applying the band's settings if it changed. Returns the band. */
+	EShooterSignificance UpdateEntry(AActor* Actor, float Distance, EShooterSignificance MostSignificantAllowed, EShooterSignificance LeastSignificantAllowed);
+
+	/** Applies the band's tick settings. The mesh's are left alone if it is ticked by the animation budget allocator. */
+	static void ApplyCharacterBand(AShooterCharacter* Character, EShooterSignificance Band, bool bBudgetedMesh);
+
+	/** Hands the mesh's significance to the animation budget allocator, protecting characters in combat. */
+	void ApplyAnimationBudget(AShooterCharacter* Character, float AnimationSignificance) const;
+
+	/** Turns the world's animation budget allocator on or off, following slime.Significance.AnimationBudget. */
+	void SyncAnimationBudget();
+
+	static void ApplyItemBand(AActor* Item, EShooterSignificance Band);
+
+	/** Puts every tracked object back at full rate, and forgets them. */
+	void RestoreAll();
+
+	TArray<AShooterCharacter*> Characters;
+	TMap<TWeakObjectPtr<AActor>, FSignificanceEntry> Entries;
+
+	/** Player viewpoints of the current update. */
+	TArray<FTransform, TInlineAllocator<4>> Viewpoints;
+
+	int32 NumCharacters[static_cast<int32>(EShooterSignificance::MAX)]{};
+	int32 NumItems[static_cast<int32>(EShooterSignificance::MAX)]{};
+
+	float TimeSinceUpdate{ 0.f };
+	uint32 UpdateCount{ 0 };
+	bool bWasEnabled{ false };
+	/** Whether character meshes are handed to the animation budget allocator, and whether the allocator was told yet. */
+	bool bAnimationBudget{ false };
+	bool bAnimationBudgetSynced{ false };
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterWaterVolume.h"
+
+#include "Components/BrushComponent.h"
+
+AShooterWaterVolume::AShooterWaterVolume(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer),
+	SurfaceHeight(0.f)
+{
+	// Characters wade through the water as they always have, so the movement component shouldn't switch to swimming.
+	bWaterVolume = false;
+
+	// Pawns have to overlap the brush for their physics volume to change.
+	GetBrushComponent()->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+}
+
+void AShooterWaterVolume::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	UpdateSurfaceHeight();
+}
+
+void AShooterWaterVolume::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	UpdateSurfaceHeight();
+}
+
+void AShooterWaterVolume::UpdateSurfaceHeight()
+{
+	const FBoxSphereBounds& Bounds{ GetBrushComponent()->Bounds };
+	SurfaceHeight = Bounds.Origin.Z + Bounds.BoxExtent.Z;
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "ShooterWaterVolume.generated.h"
+
+/**
+ * A body of water. Characters learn they have entered or left one from their capsule's physics volume changes, and
+ * compare their camera against the surface height cached here, instead of tracing for water every frame.
+ * The surface is the top of the volume's bounds.
+ */
+UCLASS()
+class SLIME_API AShooterWaterVolume : public APhysicsVolume
+{
+	GENERATED_BODY()
+
+public:
+	AShooterWaterVolume(const FObjectInitializer& ObjectInitializer);
+
+	virtual void PostInitializeComponents() override;
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	FORCEINLINE float GetSurfaceHeight() const { return SurfaceHeight; }
+
+	/** True if Location is at least Depth below the surface. */
+	FORCEINLINE bool IsBelowSurface(const FVector& Location, float Depth = 0.f) const { return Location.Z + Depth < SurfaceHeight; }
+
+private:
+	void UpdateSurfaceHeight();
+
+	/** World Z of the water surface. */
+	UPROPERTY(VisibleInstanceOnly, Category = Water)
+	float SurfaceHeight;
+};
@@ -12,8 +12,11 @@ public class Slime : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] {  });
 
-		// Uncomment if you are using Slate UI
-		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+		// Animation budget allocator and animation sharing, for the characters' meshes.
+		PrivateDependencyModuleNames.AddRange(new string[] { "AnimationBudgetAllocator", "AnimationSharing", "SignificanceManager" });
+
+		// Slate UI, for the native crosshair.
+		PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -4,3 +4,7 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Slime, "Slime" );
+
+DEFINE_LOG_CATEGORY(LogSlime);
+
+DEFINE_STAT(STAT_HUDWidgetUpdates);
@@ -9,3 +9,25 @@
 #define EPS_WATER EPhysicalSurface::SurfaceType2
 #define EPS_SNOW EPhysicalSurface::SurfaceType3
 #define EPS_UNDERWATER EPhysicalSurface::SurfaceType4
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSlime, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Slime"), STATGROUP_Slime, STATCAT_Advanced);
+
+/** Time spent in HUD widget handlers, by either the HUD model or the per-event delegates. */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HUD Widget Updates"), STAT_HUDWidgetUpdates, STATGROUP_Slime, SLIME_API);
+
+/**
+ * Runs Step once, then again while HasWork() and less than BudgetMs has passed since StartTime. Work spread over frames
+ * this way always makes progress, so its queue drains even with a budget of zero or a single step over budget.
+ */
+template <typename HasWorkType, typename StepType>
+void RunWithinFrameBudget(double StartTime, float BudgetMs, HasWorkType&& HasWork, StepType&& Step)
+{
+	const double BudgetSeconds{ FMath::Max(BudgetMs, 0.f) / 1000.0 };
+	do
+	{
+		Step();
+	}
+	while (HasWork() && FPlatformTime::Seconds() - StartTime < BudgetSeconds);
+}
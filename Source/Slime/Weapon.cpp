@@ -3,9 +3,11 @@
 
 #include "Weapon.h"
 
-AWeapon::AWeapon() :
-	FallingWeaponDuration(1.2f),
-	bFalling(false),
+#include "Components/StaticMeshComponent.h"
+
+AWeapon::AWeapon(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer),
+	ThrowSpeed(400.f),
 	AmmoCount(36),
 	WeaponType(EWeaponType::EWT_SubmachineGun),
 	MagazineCapacity(36),
@@ -17,37 +19,21 @@ AWeapon::AWeapon() :
 	// Empty constructor.
 }
 
-//void AWeapon::Tick(float DeltaTime)
-//{
-//	Super::Tick(DeltaTime);
-//	if (bFalling && GetItemState() == EItemState::EIS_Falling)
-//	{
-//		const FRotator MeshRotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
-//		GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
-//	}
-//	
-//}
-
 void AWeapon::ThrowWeapon()
 {
-	FRotator MeshRotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
-	GetItemMesh()->SetWorldRotation(MeshRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	FRotator MeshRotation{ 0.f, GetActorRotation().Yaw, 0.f };
+	SetActorRotation(MeshRotation);
 
-	const FVector MeshForward{ GetItemMesh()->GetForwardVector() };
-	const FVector MeshRight{ GetItemMesh()->GetRightVector() };
+	const FVector MeshForward{ GetActorForwardVector() };
+	const FVector MeshRight{ GetActorRightVector() };
 	
 	// Direction in which we throw the weapon (forward, right, and slightly down).
-	FVector ImpulseDirection = MeshRight.RotateAngleAxis(-20.f, MeshForward);
+	FVector ThrowDirection = MeshRight.RotateAngleAxis(-20.f, MeshForward);
 
 	const float RandomRotation{ FMath::FRandRange(20.f, 40.f) };
-	// const float RandomRotation{ 30.f };
-
-	ImpulseDirection = ImpulseDirection.RotateAngleAxis(RandomRotation, FVector(0.f, 0.f, 1.f));
-	ImpulseDirection *= 5'500.f;
-	GetItemMesh()->AddImpulse(ImpulseDirection);
 
-	bFalling = true;
-	GetWorldTimerManager().SetTimer(FallingWeaponTimer, this, &AWeapon::StopFalling, FallingWeaponDuration);
+	ThrowDirection = ThrowDirection.RotateAngleAxis(RandomRotation, FVector(0.f, 0.f, 1.f));
+	Launch(ThrowDirection * ThrowSpeed, FMath::FRandRange(-360.f, 360.f));
 
 	EnableGlowMaterial();
 }
@@ -70,41 +56,73 @@ void AWeapon::ReloadAmmo(int32 Amount)
 	AmmoCount += Amount;
 }
 
-void AWeapon::StopFalling()
+void AWeapon::OnConstruction(const FTransform& Transform)
 {
-	bFalling = false;
-	SetItemState(EItemState::EIS_Pickup);
+	Super::OnConstruction(Transform);
+	ApplyWeaponData();
 }
 
-void AWeapon::OnConstruction(const FTransform& Transform)
+const FWeaponDataTable* AWeapon::FindWeaponData(EWeaponType Type)
 {
-	Super::OnConstruction(Transform);
-	const FString WeaponTablePath(TEXT("DataTable'/Game/_Game/DataTable/WeaponDataTable.WeaponDataTable'"));
-	UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
-	if (WeaponTableObject)
+	// Looked up on every spawn and by the inventory bar each frame, so the table is only loaded again after a GC took it.
+	static TWeakObjectPtr<UDataTable> CachedWeaponTable;
+	UDataTable* WeaponTableObject{ CachedWeaponTable.Get() };
+	if (WeaponTableObject == nullptr)
+	{
+		const TCHAR* WeaponTablePath{ TEXT("DataTable'/Game/_Game/DataTable/WeaponDataTable.WeaponDataTable'") };
+		WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, WeaponTablePath));
+		if (WeaponTableObject == nullptr) return nullptr;
+
+		CachedWeaponTable = WeaponTableObject;
+	}
+
+	static const FName SubmachineGunRow{ TEXT("SubMachineGun") };
+	static const FName AssaultRifleRow{ TEXT("AssaultRifle") };
+	switch (Type)
 	{
-		FWeaponDataTable* WeaponDataRow = nullptr;
-		switch (WeaponType)
-		{
-		case EWeaponType::EWT_SubmachineGun:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("SubMachineGun"), TEXT(""));
-			break;
-		case EWeaponType::EWT_AssaultRifle:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("AssaultRifle"), TEXT(""));
-			break;
-		}
-		if (WeaponDataRow)
-		{
-				AmmoType = WeaponDataRow->AmmoType;
-				AmmoCount = WeaponDataRow->AmmoCount;
-				MagazineCapacity = WeaponDataRow->MagazineCapacity;
-				SetPickupSound(WeaponDataRow->PickupSound);
-				SetEquipSound(WeaponDataRow->EquipSound);
-				GetItemMesh()->SetSkeletalMesh(WeaponDataRow->ItemMesh);
-				SetItemName(WeaponDataRow->ItemName);
-				SetIconImage(WeaponDataRow->InventoryIcon);
-				SetAmmoIcon(WeaponDataRow->AmmoIcon);
-		}
-	}	
+	case EWeaponType::EWT_SubmachineGun:
+		return WeaponTableObject->FindRow<FWeaponDataTable>(SubmachineGunRow, TEXT(""));
+	case EWeaponType::EWT_AssaultRifle:
+		return WeaponTableObject->FindRow<FWeaponDataTable>(AssaultRifleRow, TEXT(""));
+	default:
+		return nullptr;
+	}
+}
+
+void AWeapon::ApplyWeaponData()
+{
+	const FWeaponDataTable* WeaponDataRow{ FindWeaponData(WeaponType) };
+	if (WeaponDataRow)
+	{
+		AmmoType = WeaponDataRow->AmmoType;
+		AmmoCount = WeaponDataRow->AmmoCount;
+		MagazineCapacity = WeaponDataRow->MagazineCapacity;
+		SetPickupSound(WeaponDataRow->PickupSound);
+		SetEquipSound(WeaponDataRow->EquipSound);
+		GetItemMesh()->SetSkeletalMesh(WeaponDataRow->ItemMesh);
+		GetPickupMesh()->SetStaticMesh(WeaponDataRow->PickupMesh);
+		SetItemName(WeaponDataRow->ItemName);
+		SetIconImage(WeaponDataRow->InventoryIcon);
+		SetAmmoIcon(WeaponDataRow->AmmoIcon);
+	}
+}
+
+FWeaponInstanceRecord AWeapon::MakeInstanceRecord() const
+{
+	FWeaponInstanceRecord Record;
+	Record.WeaponClass = GetClass();
+	Record.WeaponType = WeaponType;
+	Record.Rarity = GetItemRarity();
+	Record.AmmoCount = AmmoCount;
+	return Record;
+}
+
+void AWeapon::ApplyInstanceRecord(const FWeaponInstanceRecord& Record)
+{
+	SetWeaponType(Record.WeaponType);
+	SetItemRarity(Record.Rarity);
+	ApplyRarityData();
+	ApplyWeaponData();
+	AmmoCount = FMath::Clamp(Record.AmmoCount, 0, MagazineCapacity);
 }
 
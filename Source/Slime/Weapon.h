@@ -40,6 +40,10 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	USkeletalMesh* ItemMesh;
 
+	/** Static stand-in for ItemMesh, shown while the weapon is on the ground. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UStaticMesh* PickupMesh;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString ItemName;
 
@@ -50,6 +54,30 @@ struct FWeaponDataTable : public FTableRowBase
 	UTexture2D* AmmoIcon;
 };
 
+/**
+ * A carried weapon, as stored in the character's inventory. Only the equipped weapon is an actor, and it is
+ * re-skinned from these records when switching weapons.
+ */
+USTRUCT(BlueprintType)
+struct FWeaponInstanceRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TSubclassOf<class AWeapon> WeaponClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 AmmoCount{ 0 };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EWeaponType WeaponType{ EWeaponType::EWT_MAX };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EItemRarity Rarity{ EItemRarity::EIR_Common };
+
+	FORCEINLINE bool IsSet() const { return WeaponClass != nullptr; }
+};
+
 /**
  * 
  */
@@ -59,20 +87,18 @@ class SLIME_API AWeapon : public AItem
 	GENERATED_BODY()
 
 public:
-	AWeapon();
-	
-	// Contains code to keep weapon upright. Not currently used. 
-	//	void Tick(float DeltaTime);
+	AWeapon(const FObjectInitializer& ObjectInitializer);
 
 protected:
-	void StopFalling();
-
 	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** Loads sounds, meshes, icons and ammo for WeaponType from the weapon data table. */
+	void ApplyWeaponData();
 	
 private:
-	FTimerHandle FallingWeaponTimer;
-	float FallingWeaponDuration;
-	bool bFalling;
+	/** Launch speed when the weapon is thrown / dropped. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float ThrowSpeed;
 
 	/** Ammo count for this weapon. */ 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
@@ -100,17 +126,24 @@ private:
 	/** Clip / mag name. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	FName ClipBoneName;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	UDataTable* WeaponDataTable;
-	
 	
 public:
 	void ThrowWeapon();
+
+	/** Row of the weapon data table for the weapon type, or null if there is none. */
+	static const FWeaponDataTable* FindWeaponData(EWeaponType Type);
+
+	/** Captures what is needed to rebuild this weapon later. */
+	FWeaponInstanceRecord MakeInstanceRecord() const;
+
+	/** Turns this weapon into the one described by the record, keeping its components and state. */
+	void ApplyInstanceRecord(const FWeaponInstanceRecord& Record);
 	FORCEINLINE int32 GetAmmo() const { return AmmoCount; }
 	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
 	void DecrementAmmo();
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
+	/** Only meaningful before construction scripts run (e.g. deferred spawning), since weapon data is loaded in OnConstruction(). */
+	FORCEINLINE void SetWeaponType(const EWeaponType Type) { WeaponType = Type; }
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
 	FORCEINLINE FName GetReloadMontageSection() const { return ReloadMontageSection; }
 	void ReloadAmmo(int32 Amount);